@@ -0,0 +1,222 @@
+/*******************************************************************************
+* 文 件 名: bench_fifo.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: FIFO基准, 比较通用接口与类型化快速操作每个元素进出队列的周期数
+*******************************************************************************/
+
+#include "cpulib_fifo.h"
+#include "host_bench.h"
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+#define BENCH_FIFO_LEN              ( 256 )
+#define BENCH_DEFAULT_ROUNDS        ( 20000 )
+#define BENCH_REPEAT                ( 5 )
+
+/*
+ * 生成指定元素类型的各项测试函数, 每轮先写满FIFO再全部读出,
+ * 返回rounds轮消耗的周期数
+ */
+#define BENCH_FIFO_DEFINE(name, type)                                       \
+static STRUCT_FIFO(type, BENCH_FIFO_LEN)      fifo##name;                   \
+static STRUCT_SPSC_FIFO(type, BENCH_FIFO_LEN) spsc##name;                   \
+static uint64_t prvRunIn##name(size_t rounds)                               \
+{                                                                           \
+uint64_t t0 = bench_Cycles();                                               \
+uint32_t sum = 0;                                                           \
+type v = 0;                                                                 \
+size_t r, i;                                                                \
+    for ( r = 0; r < rounds; r++ )                                          \
+    {                                                                       \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            v = (type)(r + i);                                              \
+            fifo_In(&fifo##name, &v, 1);                                    \
+        }                                                                   \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            fifo_Out(&fifo##name, &v, 1);                                   \
+            sum += v;                                                       \
+        }                                                                   \
+    }                                                                       \
+    benchSink += sum;                                                       \
+    return ( bench_Cycles() - t0 );                                         \
+}                                                                           \
+static uint64_t prvRunBulk##name(size_t rounds)                             \
+{                                                                           \
+static type src[BENCH_FIFO_LEN], dst[BENCH_FIFO_LEN];                       \
+uint64_t t0 = bench_Cycles();                                               \
+uint32_t sum = 0;                                                           \
+size_t r;                                                                   \
+    for ( r = 0; r < rounds; r++ )                                          \
+    {                                                                       \
+        src[r % BENCH_FIFO_LEN] = (type)r;                                  \
+        fifo_In(&fifo##name, src, BENCH_FIFO_LEN);                          \
+        fifo_Out(&fifo##name, dst, BENCH_FIFO_LEN);                         \
+        sum += dst[r % BENCH_FIFO_LEN];                                     \
+    }                                                                       \
+    benchSink += sum;                                                       \
+    return ( bench_Cycles() - t0 );                                         \
+}                                                                           \
+static uint64_t prvRunPut##name(size_t rounds)                              \
+{                                                                           \
+uint64_t t0 = bench_Cycles();                                               \
+uint32_t sum = 0;                                                           \
+type v = 0;                                                                 \
+size_t r, i;                                                                \
+    for ( r = 0; r < rounds; r++ )                                          \
+    {                                                                       \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            fifo_Put##name(&fifo##name, (type)(r + i));                     \
+        }                                                                   \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            fifo_Get##name(&fifo##name, &v);                                \
+            sum += v;                                                       \
+        }                                                                   \
+    }                                                                       \
+    benchSink += sum;                                                       \
+    return ( bench_Cycles() - t0 );                                         \
+}                                                                           \
+static uint64_t prvRunSpscIn##name(size_t rounds)                           \
+{                                                                           \
+uint64_t t0 = bench_Cycles();                                               \
+uint32_t sum = 0;                                                           \
+type v = 0;                                                                 \
+size_t r, i;                                                                \
+    for ( r = 0; r < rounds; r++ )                                          \
+    {                                                                       \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            v = (type)(r + i);                                              \
+            fifo_SpscIn(&spsc##name, &v, 1);                                \
+        }                                                                   \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            fifo_SpscOut(&spsc##name, &v, 1);                               \
+            sum += v;                                                       \
+        }                                                                   \
+    }                                                                       \
+    benchSink += sum;                                                       \
+    return ( bench_Cycles() - t0 );                                         \
+}                                                                           \
+static uint64_t prvRunSpscPut##name(size_t rounds)                          \
+{                                                                           \
+uint64_t t0 = bench_Cycles();                                               \
+uint32_t sum = 0;                                                           \
+type v = 0;                                                                 \
+size_t r, i;                                                                \
+    for ( r = 0; r < rounds; r++ )                                          \
+    {                                                                       \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            fifo_SpscPut##name(&spsc##name, (type)(r + i));                 \
+        }                                                                   \
+        for ( i = 0; i < BENCH_FIFO_LEN; i++ )                              \
+        {                                                                   \
+            fifo_SpscGet##name(&spsc##name, &v);                            \
+            sum += v;                                                       \
+        }                                                                   \
+    }                                                                       \
+    benchSink += sum;                                                       \
+    return ( bench_Cycles() - t0 );                                         \
+}                                                                           \
+static void prvInit##name(void)                                             \
+{                                                                           \
+    INIT_FIFO(&fifo##name);                                                 \
+    INIT_SPSC_FIFO(&spsc##name);                                            \
+}
+
+/*******************************************************************************
+
+                                    数据类型
+
+*******************************************************************************/
+typedef uint64_t (*BenchRun_t)(size_t rounds);
+
+/*一种元素类型的全部测试项*/
+typedef struct
+{
+    const char *name;
+    void      (*init)(void);
+    BenchRun_t  run[5];
+} BenchType_t;
+
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+/*保存读出数据的累加值, 防止编译器优化掉读操作*/
+static volatile uint32_t benchSink;
+
+static const char * const benchNames[5] =
+{
+    "In/Out", "bulk", "Put/Get", "SpscIn/Out", "SpscPut/Get"
+};
+
+BENCH_FIFO_DEFINE(U8,  uint8_t)
+BENCH_FIFO_DEFINE(U16, uint16_t)
+BENCH_FIFO_DEFINE(U32, uint32_t)
+
+static const BenchType_t benchTypes[] =
+{
+    { "U8",  prvInitU8,  { prvRunInU8,  prvRunBulkU8,  prvRunPutU8,  prvRunSpscInU8,  prvRunSpscPutU8  } },
+    { "U16", prvInitU16, { prvRunInU16, prvRunBulkU16, prvRunPutU16, prvRunSpscInU16, prvRunSpscPutU16 } },
+    { "U32", prvInitU32, { prvRunInU32, prvRunBulkU32, prvRunPutU32, prvRunSpscInU32, prvRunSpscPutU32 } },
+};
+
+/*******************************************************************************
+
+                                     主函数
+
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+size_t rounds = BENCH_DEFAULT_ROUNDS, i, k, n;
+uint64_t t, best;
+
+    if ( argc > 1 )
+    {
+        rounds = strtoul(argv[1], NULL, 0);
+    }
+    if ( 0 == rounds )
+    {
+        rounds = 1;
+    }
+    printf("fifo %u elements, %s per element (in + out), best of %u\n",
+           (unsigned)BENCH_FIFO_LEN, BENCH_CYCLE_UNIT, (unsigned)BENCH_REPEAT);
+    printf("%-5s", "type");
+    for ( k = 0; k < ARRAY_SIZE(benchNames); k++ )
+    {
+        printf(" %11s", benchNames[k]);
+    }
+    printf("\n");
+    for ( i = 0; i < ARRAY_SIZE(benchTypes); i++ )
+    {
+        benchTypes[i].init();
+        printf("%-5s", benchTypes[i].name);
+        for ( k = 0; k < ARRAY_SIZE(benchNames); k++ )
+        {
+            /*先运行一次预热缓存, 再取多次运行的最小值*/
+            benchTypes[i].run[k](rounds/10 + 1);
+            best = UINT64_MAX;
+            for ( n = 0; n < BENCH_REPEAT; n++ )
+            {
+                t = benchTypes[i].run[k](rounds);
+                if ( t < best )
+                {
+                    best = t;
+                }
+            }
+            printf(" %11.2f", (double)best/((double)rounds*BENCH_FIFO_LEN));
+        }
+        printf("\n");
+    }
+    return (0);
+}
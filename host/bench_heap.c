@@ -0,0 +1,215 @@
+/*******************************************************************************
+* 文 件 名: bench_heap.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: Heap分配算法基准, 在首次适应与TLSF算法上回放相同的分配序列
+*******************************************************************************/
+
+#include "cpulib_heap.h"
+#include "host_bench.h"
+#include <string.h>
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+#define BENCH_HEAP_SIZE             ( 256*1024 )
+#define BENCH_MAX_SLOTS             ( 512 )
+#define BENCH_DEFAULT_OPS           ( 200000 )
+
+/*******************************************************************************
+
+                                    数据类型
+
+*******************************************************************************/
+/*分配序列中的一次操作, size为0表示释放slot中的内存*/
+typedef struct
+{
+    uint32_t    slot;
+    uint32_t    size;
+} TraceOp_t;
+
+/*分配序列生成参数*/
+typedef struct
+{
+    const char *name;
+    uint32_t    maxLive;            /*同时存在的最大分配数*/
+    uint32_t  (*sizeOf)(void);      /*生成一次分配的大小  */
+} Workload_t;
+
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+static uint8_t heapBuffer[BENCH_HEAP_SIZE] __attribute__((aligned(8)));
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/*8~64字节的小对象*/
+static uint32_t prvSizeSmall(void)
+{
+    return ( 8 + bench_Rand()%57 );
+}
+
+/*8~4096字节, 按对数均匀分布*/
+static uint32_t prvSizeMixed(void)
+{
+uint32_t shift = 3 + bench_Rand()%10;
+
+    return ( (1U << shift) + bench_Rand()%(1U << shift) ) / 2 + 4;
+}
+
+/*大量16字节小对象夹杂1~3KB的大块, 容易产生碎片*/
+static uint32_t prvSizeBimodal(void)
+{
+    if ( 0 == bench_Rand()%8 )
+    {
+        return ( 1024 + bench_Rand()%2048 );
+    }
+    return (16);
+}
+
+/*长期存在的大量小对象之间留下许多小空洞, 大块分配需要跨过这些空洞*/
+static uint32_t prvSizeHoles(void)
+{
+    if ( 0 == bench_Rand()%16 )
+    {
+        return ( 2048 + bench_Rand()%2048 );
+    }
+    return ( 24 + bench_Rand()%8 );
+}
+
+static const Workload_t workloads[] =
+{
+    { "small",   256, prvSizeSmall   },
+    { "mixed",   96,  prvSizeMixed   },
+    { "bimodal", 160, prvSizeBimodal },
+    { "holes",   500, prvSizeHoles   },
+};
+
+/*生成分配序列, 最后释放全部仍存在的分配, 返回操作数*/
+static size_t prvTraceGenerate(const Workload_t *wl, TraceOp_t *ops, size_t count)
+{
+uint32_t live[BENCH_MAX_SLOTS];
+uint32_t freeSlots[BENCH_MAX_SLOTS];
+uint32_t nLive = 0, nFree = 0, i, k;
+size_t n = 0;
+
+    for ( i = 0; i < BENCH_MAX_SLOTS; i++ )
+    {
+        freeSlots[nFree++] = BENCH_MAX_SLOTS - 1 - i;
+    }
+    bench_Seed(0x12345678UL);
+    while ( n < count - wl->maxLive )
+    {
+        if ( (0 == nLive) || ((nLive < wl->maxLive) && (0 != bench_Rand()%2)) )
+        {
+            ops[n].slot = freeSlots[--nFree];
+            ops[n].size = wl->sizeOf();
+            live[nLive++] = ops[n].slot;
+        }
+        else
+        {
+            k = bench_Rand()%nLive;
+            ops[n].slot = live[k];
+            ops[n].size = 0;
+            freeSlots[nFree++] = live[k];
+            live[k] = live[--nLive];
+        }
+        n++;
+    }
+    while ( 0 != nLive )
+    {
+        ops[n].slot = live[--nLive];
+        ops[n].size = 0;
+        n++;
+    }
+    return (n);
+}
+
+/*在指定算法的Heap上回放分配序列并打印统计结果*/
+static void prvTraceReplay(const char *name, const TraceOp_t *ops, size_t count, HeapAlgo_t algo)
+{
+void *ptrs[BENCH_MAX_SLOTS];
+uint32_t *lat = malloc(count*sizeof(uint32_t));
+HeapDev_t *heap;
+HeapInfo_t init, info;
+uint64_t t0, t1, total = 0;
+size_t i, fails = 0;
+
+    memset(heapBuffer, 0, sizeof(heapBuffer));
+    memset(ptrs, 0, sizeof(ptrs));
+    heap = heap_CreateEx(heapBuffer, sizeof(heapBuffer), algo);
+    CPU_Assert(NULL != heap);
+    heap_GetInfo(heap, &init);
+    for ( i = 0; i < count; i++ )
+    {
+        if ( 0 != ops[i].size )
+        {
+            t0 = bench_Nanoseconds();
+            ptrs[ops[i].slot] = heap_Malloc(heap, ops[i].size);
+            t1 = bench_Nanoseconds();
+            if ( NULL == ptrs[ops[i].slot] )
+            {
+                fails++;
+            }
+        }
+        else
+        {
+            t0 = bench_Nanoseconds();
+            heap_Free(heap, ptrs[ops[i].slot]);
+            t1 = bench_Nanoseconds();
+            ptrs[ops[i].slot] = NULL;
+        }
+        lat[i] = (uint32_t)(t1 - t0);
+        total += t1 - t0;
+    }
+    /*全部释放后空闲内存应恢复为一整块*/
+    heap_GetInfo(heap, &info);
+    CPU_Assert(info.freeSize == init.freeSize);
+    CPU_Assert(1 == info.freeBlocks);
+    bench_SortU32(lat, count);
+    printf("%-8s %-9s %8zu %8.1f %8u %8u %6zu %9zu\n", name,
+           (HEAP_ALGO_TLSF == algo) ? "tlsf" : "firstfit", count,
+           (double)total/count, lat[count*99/100], lat[count - 1],
+           fails, info.minimumEverFreeSize);
+    free(lat);
+}
+
+/*******************************************************************************
+
+                                     主函数
+
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+size_t count = BENCH_DEFAULT_OPS, n, i;
+TraceOp_t *ops;
+
+    if ( argc > 1 )
+    {
+        count = strtoul(argv[1], NULL, 0);
+    }
+    if ( count < 2*BENCH_MAX_SLOTS )
+    {
+        count = 2*BENCH_MAX_SLOTS;
+    }
+    ops = malloc(count*sizeof(TraceOp_t));
+    printf("heap %u bytes, latency in ns (includes ~%u ns timer overhead)\n",
+           (unsigned)BENCH_HEAP_SIZE, (unsigned)bench_TimerOverhead());
+    printf("%-8s %-9s %8s %8s %8s %8s %6s %9s\n",
+           "workload", "algo", "ops", "avg", "p99", "max", "fails", "minFree");
+    for ( i = 0; i < ARRAY_SIZE(workloads); i++ )
+    {
+        n = prvTraceGenerate(&workloads[i], ops, count);
+        prvTraceReplay(workloads[i].name, ops, n, HEAP_ALGO_FIRSTFIT);
+        prvTraceReplay(workloads[i].name, ops, n, HEAP_ALGO_TLSF);
+    }
+    free(ops);
+    return (0);
+}
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* 文 件 名: bench_wheel.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 时间轮基准, 比较分层时间轮与逐个递减计数的线性链表
+*           在不同定时器数量下每个节拍的处理开销
+*******************************************************************************/
+
+#include "cpulib_wheel.h"
+#include "host_bench.h"
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+#define BENCH_DEFAULT_TICKS         ( 100000 )
+#define BENCH_PERIOD_MIN            ( 10 )
+#define BENCH_PERIOD_MAX            ( 1000 )
+
+/*******************************************************************************
+
+                                    数据类型
+
+*******************************************************************************/
+/*线性链表节拍定时器, 与时间轮之前的节拍中断请求处理方式相同*/
+typedef struct
+{
+    ListNode_t  node;
+    tick_t      period;
+    tick_t      count;
+} LinearTimer_t;
+
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+static const uint32_t benchCounts[] = { 8, 32, 128, 512, 2048, 8192 };
+
+/*定时器到期次数, 两种实现到期次数应相同*/
+static uint64_t benchFired;
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+static void prvWheelHandler(WheelTimer_t *timer)
+{
+    (void)timer;
+    benchFired++;
+}
+
+/*线性链表节拍处理, 每个节拍遍历全部定时器*/
+static void prvLinearTick(ListHead_t *list)
+{
+ListNode_t *pos;
+LinearTimer_t *timer;
+
+    list_for_each(pos, list)
+    {
+        timer = list_entry(pos, LinearTimer_t, node);
+        if ( timer->count > 0 )
+        {
+            timer->count--;
+        }
+        else
+        {
+            timer->count = timer->period - 1;
+            benchFired++;
+        }
+    }
+}
+
+/*统计每个节拍的平均, p99及最大开销并打印*/
+static void prvReport(const char *name, uint32_t count, uint32_t *lat, uint32_t ticks, uint64_t fired)
+{
+uint64_t total = 0;
+uint32_t i;
+
+    for ( i = 0; i < ticks; i++ )
+    {
+        total += lat[i];
+    }
+    bench_SortU32(lat, ticks);
+    printf("%-7s %7u %10.1f %10u %10u %10llu\n", name, (unsigned)count, (double)total/ticks,
+           (unsigned)lat[ticks*99/100], (unsigned)lat[ticks - 1], (unsigned long long)fired);
+}
+
+static void prvBenchLinear(uint32_t count, uint32_t ticks, uint64_t *fired)
+{
+LinearTimer_t *timers = malloc(count*sizeof(LinearTimer_t));
+ListHead_t list;
+uint32_t *lat = malloc(ticks*sizeof(uint32_t));
+uint64_t t0;
+uint32_t i;
+
+    list_Init(&list);
+    bench_Seed(count);
+    for ( i = 0; i < count; i++ )
+    {
+        timers[i].period = BENCH_PERIOD_MIN + bench_Rand()%(BENCH_PERIOD_MAX - BENCH_PERIOD_MIN + 1);
+        timers[i].count  = timers[i].period - 1;
+        list_Init(&timers[i].node);
+        list_AddTail(&list, &timers[i].node);
+    }
+    benchFired = 0;
+    for ( i = 0; i < ticks; i++ )
+    {
+        t0 = bench_Cycles();
+        prvLinearTick(&list);
+        lat[i] = (uint32_t)(bench_Cycles() - t0);
+    }
+    *fired = benchFired;
+    prvReport("linear", count, lat, ticks, benchFired);
+    free(lat);
+    free(timers);
+}
+
+static void prvBenchWheel(uint32_t count, uint32_t ticks, uint64_t *fired)
+{
+WheelTimer_t *timers = malloc(count*sizeof(WheelTimer_t));
+TimeWheel_t wheel;
+uint32_t *lat = malloc(ticks*sizeof(uint32_t));
+uint64_t t0;
+uint32_t i;
+tick_t period;
+
+    wheel_Init(&wheel);
+    bench_Seed(count);
+    for ( i = 0; i < count; i++ )
+    {
+        period = BENCH_PERIOD_MIN + bench_Rand()%(BENCH_PERIOD_MAX - BENCH_PERIOD_MIN + 1);
+        wheel_TimerInit(&timers[i], prvWheelHandler);
+        wheel_Add(&wheel, &timers[i], period, period);
+    }
+    benchFired = 0;
+    for ( i = 0; i < ticks; i++ )
+    {
+        t0 = bench_Cycles();
+        wheel_Tick(&wheel);
+        lat[i] = (uint32_t)(bench_Cycles() - t0);
+    }
+    *fired = benchFired;
+    prvReport("wheel", count, lat, ticks, benchFired);
+    free(lat);
+    free(timers);
+}
+
+/*******************************************************************************
+
+                                     主函数
+
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+uint32_t ticks = BENCH_DEFAULT_TICKS;
+uint64_t linearFired, wheelFired;
+size_t i;
+
+    if ( argc > 1 )
+    {
+        ticks = strtoul(argv[1], NULL, 0);
+    }
+    if ( 0 == ticks )
+    {
+        ticks = 1;
+    }
+    printf("%u ticks, periods %u..%u ticks, %s per tick\n", (unsigned)ticks,
+           (unsigned)BENCH_PERIOD_MIN, (unsigned)BENCH_PERIOD_MAX, BENCH_CYCLE_UNIT);
+    printf("%-7s %7s %10s %10s %10s %10s\n", "impl", "timers", "avg", "p99", "max", "fired");
+    for ( i = 0; i < ARRAY_SIZE(benchCounts); i++ )
+    {
+        prvBenchLinear(benchCounts[i], ticks, &linearFired);
+        prvBenchWheel(benchCounts[i], ticks, &wheelFired);
+        CPU_Assert(linearFired == wheelFired);
+    }
+    return (0);
+}
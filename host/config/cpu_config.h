@@ -0,0 +1,27 @@
+/*******************************************************************************
+* MCU型 号: HOST
+* 文 件 名: cpu_config.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 主机CPU配置文件
+*******************************************************************************/
+
+#ifndef __CPU_CONFIG_H
+#define __CPU_CONFIG_H
+
+/* CPU参数配置 ---------------------------------------------------------------*/
+#define CPU_TICK_HZ         ( (uint32_t) 1000 )     /* CPU节拍频率(Hz)        */
+#define CPU_BYTE_ALIGNMENT  ( 8 )                   /* CPU内存字节对齐        */
+
+/* CPU调试配置 ---------------------------------------------------------------*/
+#define CPU_ASSERT_EN       ( 1 )                   /* 调试断言功能使能       */
+#define CPU_PRINTF_EN       ( 1 )                   /* 调试输出功能使能       */
+
+/* CPU宏定义 -----------------------------------------------------------------*/
+#define CPU_TICK_PERIOD_IS_1MS
+
+/* 公共库配置 ----------------------------------------------------------------*/
+#define HEAP_USE_TRACE      ( 1 )                   /* 测试分配追踪           */
+
+#endif  /* __CPU_CONFIG_H */
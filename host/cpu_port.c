@@ -0,0 +1,82 @@
+/*******************************************************************************
+* MCU型 号: HOST
+* 文 件 名: cpu_port.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 主机(Linux/GCC)CPU接口实现
+*******************************************************************************/
+
+#include "cpu_port.h"
+#include <pthread.h>
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+/*模拟关闭中断的全局互斥锁*/
+static pthread_mutex_t cpuHostMutex = PTHREAD_MUTEX_INITIALIZER;
+/*当前线程的临界区嵌套层数*/
+static __thread ubase_t cpuHostNesting = 0;
+/*当前线程是否模拟中断源*/
+static __thread bool cpuHostHandler = false;
+
+/*******************************************************************************
+
+                                    操作函数
+
+*******************************************************************************/
+/**
+ * 进入临界区, 最外层临界区获取全局互斥锁
+ *
+ * @return: 返回进入前的嵌套层数, 由cpu_irq_restore()恢复
+ */
+cpu_t cpu_irq_save(void)
+{
+    if ( 0 == cpuHostNesting )
+    {
+        pthread_mutex_lock(&cpuHostMutex);
+    }
+    return (cpu_t)( cpuHostNesting++ );
+}
+
+/**
+ * 退出临界区, 退出最外层临界区时释放全局互斥锁
+ *
+ * @param cpu_sr: cpu_irq_save()的返回值
+ */
+void cpu_irq_restore(cpu_t cpu_sr)
+{
+    cpuHostNesting = (ubase_t)cpu_sr;
+    if ( 0 == cpuHostNesting )
+    {
+        pthread_mutex_unlock(&cpuHostMutex);
+    }
+}
+
+/**
+ * 判断当前线程是否模拟中断源
+ */
+bool cpu_HostInHandlerMode(void)
+{
+    return (cpuHostHandler);
+}
+
+/**
+ * 设置当前线程是否模拟中断源
+ *
+ * @param handler: true表示当前线程作为中断源运行
+ */
+void cpu_HostSetHandlerMode(bool handler)
+{
+    cpuHostHandler = handler;
+}
+
+/**
+ * 断言失败处理, 打印位置后终止程序
+ */
+void cpu_HostAssertFailed(const char *file, int line, const char *expr)
+{
+    fprintf(stderr, "%s:%d: assertion failed: %s\n", file, line, expr);
+    abort();
+}
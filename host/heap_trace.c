@@ -0,0 +1,437 @@
+/*******************************************************************************
+* 文 件 名: heap_trace.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: Heap追踪缓冲区解码与回放工具
+*
+*   heap_trace [-w 4|8] [-b] [-n count] [-l] [-r] [-s size] dump.bin
+*     dump.bin: 从目标CPU导出的追踪缓冲区内存(HeapTraceEvent_t数组)
+*     -w:       目标CPU的size_t/指针字节数, 默认4
+*     -b:       目标CPU为大端字节序, 默认小端
+*     -n:       heap_TraceGetCount的返回值, 默认等于缓冲区容量
+*     -l:       按时间顺序列出全部事件
+*     -r:       在首次适应与TLSF算法的Heap上回放事件序列并比较碎片情况
+*     -s:       回放使用的Heap大小, 默认为序列峰值占用的4倍
+*   heap_trace -t
+*     自测试: 在主机Heap上记录追踪事件, 解码并与实际调用比较
+*******************************************************************************/
+
+#include "cpulib_heap.h"
+#include "host_bench.h"
+#include <string.h>
+#include <unistd.h>
+/*******************************************************************************
+
+                                    数据类型
+
+*******************************************************************************/
+/*解码后的追踪事件*/
+typedef struct
+{
+    uint64_t    caller;
+    uint64_t    ptr;
+    uint64_t    size;
+    bool        isFree;
+} TraceEvent_t;
+
+/*按调用者汇总的统计*/
+typedef struct
+{
+    uint64_t    caller;
+    size_t      allocs;
+    size_t      frees;
+    size_t      fails;
+    uint64_t    bytes;
+} CallerStat_t;
+
+/*回放操作, size为0表示释放slot中的内存*/
+typedef struct
+{
+    uint32_t    slot;
+    uint32_t    size;
+} ReplayOp_t;
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/*按目标字节序读取一个字*/
+static uint64_t prvReadWord(const uint8_t *p, unsigned width, bool bigEndian)
+{
+uint64_t v = 0;
+unsigned i;
+
+    for ( i = 0; i < width; i++ )
+    {
+        if ( bigEndian )
+        {
+            v = (v << 8) | p[i];
+        }
+        else
+        {
+            v |= (uint64_t)p[i] << (8*i);
+        }
+    }
+    return (v);
+}
+
+/*
+ * 将追踪缓冲区按时间顺序解码
+ * return: 有效事件数, 缓冲区回绕时只保留最近的capacity个事件
+ */
+static size_t prvTraceDecode(const uint8_t *dump, size_t capacity, uint64_t total,
+                             unsigned width, bool bigEndian, TraceEvent_t *events)
+{
+uint64_t freeFlag = (uint64_t)1 << (8*width - 1);
+size_t count, first, i, k;
+const uint8_t *p;
+
+    if ( total <= capacity )
+    {
+        count = (size_t)total;
+        first = 0;
+    }
+    else
+    {
+        count = capacity;
+        first = (size_t)(total % capacity);
+    }
+    for ( i = 0; i < count; i++ )
+    {
+        k = (first + i) % capacity;
+        p = dump + k*3*width;
+        events[i].caller = prvReadWord(p, width, bigEndian);
+        events[i].ptr    = prvReadWord(p + width, width, bigEndian);
+        events[i].size   = prvReadWord(p + 2*width, width, bigEndian);
+        events[i].isFree = (events[i].size == freeFlag);
+    }
+    return (count);
+}
+
+/*按调用者汇总并打印*/
+static void prvTraceSummary(const TraceEvent_t *events, size_t count)
+{
+CallerStat_t *stats = calloc(count + 1, sizeof(CallerStat_t));
+size_t nStats = 0, i, k;
+
+    for ( i = 0; i < count; i++ )
+    {
+        for ( k = 0; k < nStats; k++ )
+        {
+            if ( stats[k].caller == events[i].caller )
+            {
+                break;
+            }
+        }
+        if ( k == nStats )
+        {
+            stats[nStats++].caller = events[i].caller;
+        }
+        if ( events[i].isFree )
+        {
+            stats[k].frees++;
+        }
+        else if ( 0 == events[i].ptr )
+        {
+            stats[k].fails++;
+        }
+        else
+        {
+            stats[k].allocs++;
+            stats[k].bytes += events[i].size;
+        }
+    }
+    printf("%-18s %8s %10s %8s %6s\n", "caller", "allocs", "bytes", "frees", "fails");
+    for ( k = 0; k < nStats; k++ )
+    {
+        printf("0x%016llx %8zu %10llu %8zu %6zu\n", (unsigned long long)stats[k].caller,
+               stats[k].allocs, (unsigned long long)stats[k].bytes, stats[k].frees, stats[k].fails);
+    }
+    free(stats);
+}
+
+/*
+ * 将事件序列转换为回放操作, 地址映射为slot;
+ * 分配失败的事件, 以及释放缓冲区窗口之前分配的内存的事件被忽略
+ * return: 回放操作数, *pSlots返回使用的slot数, *pPeak返回峰值占用字节数
+ */
+static size_t prvTraceToOps(const TraceEvent_t *events, size_t count, ReplayOp_t *ops,
+                            size_t *pSlots, uint64_t *pPeak)
+{
+uint64_t *livePtr = calloc(count + 1, sizeof(uint64_t));
+uint32_t *liveSlot = calloc(count + 1, sizeof(uint32_t));
+uint32_t *liveSize = calloc(count + 1, sizeof(uint32_t));
+uint64_t used = 0;
+size_t nLive = 0, nOps = 0, nSlots = 0, i, k;
+
+    *pPeak = 0;
+    for ( i = 0; i < count; i++ )
+    {
+        if ( (!events[i].isFree) && (0 == events[i].ptr) )
+        {
+            continue;
+        }
+        for ( k = 0; k < nLive; k++ )
+        {
+            if ( livePtr[k] == events[i].ptr )
+            {
+                break;
+            }
+        }
+        if ( events[i].isFree )
+        {
+            if ( k < nLive )
+            {
+                ops[nOps].slot = liveSlot[k];
+                ops[nOps].size = 0;
+                nOps++;
+                used -= liveSize[k];
+                nLive--;
+                livePtr[k]  = livePtr[nLive];
+                liveSlot[k] = liveSlot[nLive];
+                liveSize[k] = liveSize[nLive];
+            }
+        }
+        else if ( k == nLive )
+        {
+            livePtr[nLive]  = events[i].ptr;
+            liveSlot[nLive] = (uint32_t)nSlots;
+            liveSize[nLive] = (uint32_t)events[i].size;
+            ops[nOps].slot = (uint32_t)nSlots++;
+            ops[nOps].size = (0 != events[i].size) ? (uint32_t)events[i].size : 1;
+            nOps++;
+            nLive++;
+            used += events[i].size;
+            if ( used > *pPeak )
+            {
+                *pPeak = used;
+            }
+        }
+    }
+    free(livePtr);
+    free(liveSlot);
+    free(liveSize);
+    *pSlots = nSlots;
+    return (nOps);
+}
+
+/*在指定算法的Heap上回放, 打印失败次数与碎片情况*/
+static void prvTraceReplay(const ReplayOp_t *ops, size_t count, size_t slots,
+                           size_t heapSize, HeapAlgo_t algo)
+{
+uint8_t *buffer = malloc(heapSize);
+void **ptrs = calloc(slots + 1, sizeof(void *));
+HeapDev_t *heap;
+HeapInfo_t info;
+HeapFragInfo_t frag;
+double worst = 0.0, ratio;
+size_t fails = 0, i;
+
+    heap = heap_CreateEx(buffer, heapSize, algo);
+    CPU_Assert(NULL != heap);
+    for ( i = 0; i < count; i++ )
+    {
+        if ( 0 != ops[i].size )
+        {
+            ptrs[ops[i].slot] = heap_Malloc(heap, ops[i].size);
+            if ( NULL == ptrs[ops[i].slot] )
+            {
+                fails++;
+            }
+        }
+        else
+        {
+            heap_Free(heap, ptrs[ops[i].slot]);
+            ptrs[ops[i].slot] = NULL;
+        }
+        /*碎片率: 1 - 最大空闲块/空闲内存总量*/
+        heap_GetInfo(heap, &info);
+        heap_GetFragmentation(heap, &frag);
+        if ( 0 != info.freeSize )
+        {
+            ratio = 1.0 - (double)frag.largestFreeBlock/info.freeSize;
+            if ( ratio > worst )
+            {
+                worst = ratio;
+            }
+        }
+    }
+    printf("%-9s %6zu %9zu %9zu %10zu %8.1f%%\n",
+           (HEAP_ALGO_TLSF == algo) ? "tlsf" : "firstfit", fails,
+           info.minimumEverFreeSize, frag.freeBlocks, frag.largestFreeBlock, 100.0*worst);
+    free(ptrs);
+    free(buffer);
+}
+
+/*回放事件序列并比较两种算法*/
+static void prvTraceCompare(const TraceEvent_t *events, size_t count, size_t heapSize)
+{
+ReplayOp_t *ops = malloc((count + 1)*sizeof(ReplayOp_t));
+size_t nOps, slots;
+uint64_t peak;
+
+    nOps = prvTraceToOps(events, count, ops, &slots, &peak);
+    if ( 0 == heapSize )
+    {
+        heapSize = (size_t)(4*peak + 4096);
+    }
+    printf("replay %zu ops, peak %llu bytes, heap %zu bytes\n",
+           nOps, (unsigned long long)peak, heapSize);
+    printf("%-9s %6s %9s %9s %10s %9s\n",
+           "algo", "fails", "minFree", "freeBlks", "largest", "worstFrag");
+    prvTraceReplay(ops, nOps, slots, heapSize, HEAP_ALGO_FIRSTFIT);
+    prvTraceReplay(ops, nOps, slots, heapSize, HEAP_ALGO_TLSF);
+    free(ops);
+}
+
+/*
+ * 自测试: 在主机Heap上记录追踪事件, 按主机字长解码后与实际调用比较,
+ * 缓冲区容量小于事件数, 同时检验回绕后的顺序
+ */
+static int prvSelfTest(void)
+{
+enum { CAPACITY = 64, OPS = 1000, SLOTS = 32 };
+static uint8_t heapBuffer[16*1024] __attribute__((aligned(8)));
+HeapTraceEvent_t ring[CAPACITY];
+TraceEvent_t expect[OPS], decoded[CAPACITY];
+void *ptrs[SLOTS] = { NULL };
+HeapDev_t *heap;
+size_t n = 0, count, i, k, size;
+
+    heap = heap_CreateEx(heapBuffer, sizeof(heapBuffer), HEAP_ALGO_TLSF);
+    heap_TraceStart(heap, ring, CAPACITY);
+    bench_Seed(1);
+    for ( i = 0; i < OPS; i++ )
+    {
+        k = bench_Rand()%SLOTS;
+        if ( NULL == ptrs[k] )
+        {
+            size = 1 + bench_Rand()%600;
+            ptrs[k] = heap_Malloc(heap, size);
+            expect[n].ptr    = (uintptr_t)ptrs[k];
+            expect[n].size   = size;
+            expect[n].isFree = false;
+        }
+        else
+        {
+            heap_Free(heap, ptrs[k]);
+            expect[n].ptr    = (uintptr_t)ptrs[k];
+            expect[n].size   = HEAP_TRACE_FREE;
+            expect[n].isFree = true;
+            ptrs[k] = NULL;
+        }
+        n++;
+    }
+    heap_TraceStop(heap);
+    CPU_Assert(n == heap_TraceGetCount(heap));
+    count = prvTraceDecode((const uint8_t *)ring, CAPACITY, n, sizeof(size_t), false, decoded);
+    CPU_Assert(CAPACITY == count);
+    for ( i = 0; i < count; i++ )
+    {
+        k = n - count + i;
+        CPU_Assert(decoded[i].ptr == expect[k].ptr);
+        CPU_Assert(decoded[i].size == expect[k].size);
+        CPU_Assert(decoded[i].isFree == expect[k].isFree);
+    }
+    prvTraceSummary(decoded, count);
+    prvTraceCompare(decoded, count, 0);
+    printf("heap_trace self test passed\n");
+    return (0);
+}
+
+static void prvUsage(void)
+{
+    fprintf(stderr, "usage: heap_trace [-w 4|8] [-b] [-n count] [-l] [-r] [-s size] dump.bin\n"
+                    "       heap_trace -t\n");
+    exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************
+
+                                     主函数
+
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+unsigned width = 4;
+bool bigEndian = false, list = false, replay = false;
+uint64_t total = 0;
+size_t heapSize = 0, fileSize, capacity, count, i;
+uint8_t *dump;
+TraceEvent_t *events;
+FILE *fp;
+int opt;
+
+    while ( -1 != (opt = getopt(argc, argv, "w:bn:lrs:t")) )
+    {
+        switch ( opt )
+        {
+        case 'w': width    = (unsigned)strtoul(optarg, NULL, 0);    break;
+        case 'b': bigEndian = true;                                 break;
+        case 'n': total    = strtoull(optarg, NULL, 0);             break;
+        case 'l': list     = true;                                  break;
+        case 'r': replay   = true;                                  break;
+        case 's': heapSize = strtoul(optarg, NULL, 0);              break;
+        case 't': return prvSelfTest();
+        default:  prvUsage();
+        }
+    }
+    if ( (optind + 1 != argc) || ((4 != width) && (8 != width)) )
+    {
+        prvUsage();
+    }
+    fp = fopen(argv[optind], "rb");
+    if ( NULL == fp )
+    {
+        perror(argv[optind]);
+        return (EXIT_FAILURE);
+    }
+    fseek(fp, 0, SEEK_END);
+    fileSize = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    capacity = fileSize/(3*width);
+    if ( 0 == capacity )
+    {
+        fprintf(stderr, "%s: no complete event\n", argv[optind]);
+        return (EXIT_FAILURE);
+    }
+    dump = malloc(fileSize);
+    if ( fileSize != fread(dump, 1, fileSize, fp) )
+    {
+        perror(argv[optind]);
+        return (EXIT_FAILURE);
+    }
+    fclose(fp);
+    if ( 0 == total )
+    {
+        total = capacity;
+    }
+
+    events = malloc(capacity*sizeof(TraceEvent_t));
+    count  = prvTraceDecode(dump, capacity, total, width, bigEndian, events);
+    printf("%zu events (capacity %zu, total %llu)\n", count, capacity, (unsigned long long)total);
+    if ( list )
+    {
+        for ( i = 0; i < count; i++ )
+        {
+            printf("%8llu %-5s caller=0x%0*llx ptr=0x%0*llx", (unsigned long long)(total - count + i),
+                   events[i].isFree ? "free" : "alloc", (int)(2*width), (unsigned long long)events[i].caller,
+                   (int)(2*width), (unsigned long long)events[i].ptr);
+            if ( !events[i].isFree )
+            {
+                printf(" size=%llu", (unsigned long long)events[i].size);
+            }
+            printf("\n");
+        }
+    }
+    prvTraceSummary(events, count);
+    if ( replay )
+    {
+        prvTraceCompare(events, count, heapSize);
+    }
+    free(events);
+    free(dump);
+    return (0);
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+* 文 件 名: host_bench.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 主机测试与基准程序的公共函数
+*******************************************************************************/
+
+#ifndef __HOST_BENCH_H
+#define __HOST_BENCH_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpulib_def.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* 伪随机数 ------------------------------------------------------------------*/
+/*xorshift32伪随机数发生器, 固定种子使每次运行的序列相同*/
+static uint32_t benchRandState = 2463534242UL;
+
+STATIC_INLINE void bench_Seed(uint32_t seed)
+{
+    benchRandState = (0 != seed) ? seed : 2463534242UL;
+}
+
+STATIC_INLINE uint32_t bench_Rand(void)
+{
+uint32_t x = benchRandState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    benchRandState = x;
+    return (x);
+}
+
+/* 计时 ----------------------------------------------------------------------*/
+/*单调时钟, 单位ns*/
+STATIC_INLINE uint64_t bench_Nanoseconds(void)
+{
+struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ( (uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec );
+}
+
+/*连续两次读取单调时钟的最小间隔, 单位ns*/
+STATIC_INLINE uint64_t bench_TimerOverhead(void)
+{
+uint64_t t0, t1, best = UINT64_MAX;
+int i;
+
+    for ( i = 0; i < 1000; i++ )
+    {
+        t0 = bench_Nanoseconds();
+        t1 = bench_Nanoseconds();
+        if ( t1 - t0 < best )
+        {
+            best = t1 - t0;
+        }
+    }
+    return (best);
+}
+
+/*
+ * 时间戳计数, x86上为TSC周期数, 其他平台以ns代替;
+ * BENCH_CYCLE_UNIT为打印时使用的单位名称
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLE_UNIT    "cycles"
+STATIC_INLINE uint64_t bench_Cycles(void)
+{
+    return ( __rdtsc() );
+}
+#else
+#define BENCH_CYCLE_UNIT    "ns"
+STATIC_INLINE uint64_t bench_Cycles(void)
+{
+    return ( bench_Nanoseconds() );
+}
+#endif
+
+/* 排序 ----------------------------------------------------------------------*/
+STATIC_INLINE int prvBenchCompareU32(const void *a, const void *b)
+{
+uint32_t x = *(const uint32_t *)a;
+uint32_t y = *(const uint32_t *)b;
+
+    return ( (x > y) - (x < y) );
+}
+
+/*升序排列, 用于统计百分位数*/
+STATIC_INLINE void bench_SortU32(uint32_t *data, size_t count)
+{
+    qsort(data, count, sizeof(uint32_t), prvBenchCompareU32);
+}
+
+#endif  /* __HOST_BENCH_H */
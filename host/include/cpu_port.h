@@ -0,0 +1,107 @@
+/*******************************************************************************
+* MCU型 号: HOST
+* 文 件 名: cpu_port.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 主机(Linux/GCC)CPU接口定义, 用于公共库的测试与基准程序
+*******************************************************************************/
+
+#ifndef __CPU_PORT_H
+#define __CPU_PORT_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpu_config.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* 数据类型 ------------------------------------------------------------------*/
+/*CPU体系数据类型*/
+typedef int32_t         base_t;
+typedef uint32_t        ubase_t;
+typedef base_t          cpu_t;
+
+/*节拍类型*/
+#ifdef CPU_USE_16BIT_TICK
+    typedef uint16_t    tick_t;
+#else
+    typedef uint32_t    tick_t;
+#endif
+
+/* 编译器宏 ------------------------------------------------------------------*/
+/*声明数据保存在FLASH上*/
+#define FLASH_DATA
+/*声明数据保存在EEPROM上*/
+#define EEPROM_DATA
+/*静态内联函数*/
+#ifndef STATIC_INLINE
+    #define STATIC_INLINE static inline
+#endif
+
+/* 中断/临界区宏 -------------------------------------------------------------*/
+/*
+    主机上每个线程视为一个执行上下文, 以一个全局互斥锁模拟关闭中断,
+    临界区可以嵌套; 模拟中断源的线程调用cpu_HostSetHandlerMode(true),
+    使cpu_InHandlerMode()返回true
+*/
+#define CPU_EnterCritical()                 cpu_irq_save()
+#define CPU_ExitCritical(x)                 cpu_irq_restore(x)
+#define CPU_EnterCriticalFromISR()          cpu_irq_save()
+#define CPU_ExitCriticalFromISR(x)          cpu_irq_restore(x)
+
+/* 调试相关宏 ----------------------------------------------------------------*/
+/*调试断言*/
+#if CPU_ASSERT_EN
+    #define CPU_Assert(expr)    do { if (!(expr)) {cpu_HostAssertFailed(__FILE__, __LINE__, #expr);} } while(0)
+#else
+    #define CPU_Assert(expr)    ((void)0)
+#endif
+
+/*调试代码覆盖*/
+#define CPU_Coverage()          ((void)0)
+
+/*调试输出*/
+#if CPU_PRINTF_EN
+    #define CPU_Printf(...)     printf(__VA_ARGS__)
+#else
+    #define CPU_Printf(...)     ((void)0)
+#endif
+
+/* 底层操作宏 ----------------------------------------------------------------*/
+#define CPU_NOP()               ((void)0)
+#define CPU_RESET()             exit(EXIT_FAILURE)
+#define CPU_CLZ(x)              __builtin_clz(x)
+/*数据内存屏障, 保证屏障前的内存访问先于屏障后的内存访问完成*/
+#define CPU_DMB()               __sync_synchronize()
+/*主机上没有可等待的中断, 直接返回, 由调用者重新检查等待条件*/
+#define CPU_WFI()               ((void)0)
+#define CPU_RETURN_ADDRESS()    __builtin_return_address(0)
+
+/* CPU中断管理 ---------------------------------------------------------------*/
+/*判断CPU是否处于处理模式*/
+#define cpu_InHandlerMode()     cpu_HostInHandlerMode()
+
+cpu_t cpu_irq_save(void);
+void cpu_irq_restore(cpu_t cpu_sr);
+bool cpu_HostInHandlerMode(void);
+void cpu_HostSetHandlerMode(bool handler);
+void cpu_HostAssertFailed(const char *file, int line, const char *expr);
+
+/* CPU原子操作 ---------------------------------------------------------------*/
+/*
+ * 原子比较交换, 使用GCC内建原子操作实现, 不进入临界区
+ * ptr:      目标地址
+ * expected: 期望值
+ * desired:  新值
+ * return:   若*ptr等于expected, 写入desired并返回true, 否则返回false
+ */
+STATIC_INLINE bool cpu_AtomicCAS(volatile size_t *ptr, size_t expected, size_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#endif  /* __CPU_PORT_H */
@@ -0,0 +1,153 @@
+/*******************************************************************************
+* 文 件 名: test_mpsc.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: MPSC FIFO压力测试, 多个线程模拟中断生产者并发进队列,
+*           消费者检查每个生产者的元素按序到达且不丢失, 不重复
+*******************************************************************************/
+
+#include "cpulib_fifo.h"
+#include "host_bench.h"
+#include <pthread.h>
+#include <sched.h>
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+#define TEST_FIFO_LEN               ( 64 )
+#define TEST_MAX_PRODUCERS          ( 16 )
+#define TEST_DEFAULT_PRODUCERS      ( 4 )
+#define TEST_DEFAULT_COUNT          ( 200000 )
+
+/*元素高8位为生产者编号, 低24位为该生产者的序号*/
+#define TEST_ELEMENT(id, n)         ( ((uint32_t)(id) << 24) | ((uint32_t)(n) & 0xFFFFFFUL) )
+#define TEST_ELEMENT_ID(e)          ( (e) >> 24 )
+#define TEST_ELEMENT_SEQ(e)         ( (e) & 0xFFFFFFUL )
+
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+static STRUCT_MPSC_FIFO(uint32_t, TEST_FIFO_LEN) testFifo;
+static uint32_t testCount = TEST_DEFAULT_COUNT;
+/*生产者进队列失败(FIFO已满)的次数*/
+static volatile size_t testFullCount;
+/*已完成全部进队列的生产者个数*/
+static volatile uint32_t testDoneCount;
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/*生产者线程, 模拟中断函数按序写入testCount个元素*/
+static void *prvProducer(void *arg)
+{
+uint32_t id = (uint32_t)(uintptr_t)arg;
+uint32_t n, e;
+size_t full = 0;
+
+    cpu_HostSetHandlerMode(true);
+    for ( n = 0; n < testCount; n++ )
+    {
+        e = TEST_ELEMENT(id, n);
+        while ( !fifo_MpscIn(&testFifo, &e) )
+        {
+            full++;
+            sched_yield();
+        }
+    }
+    __atomic_fetch_add(&testFullCount, full, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&testDoneCount, 1, __ATOMIC_RELEASE);
+    return (NULL);
+}
+
+/*******************************************************************************
+
+                                     主函数
+
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+pthread_t threads[TEST_MAX_PRODUCERS];
+uint32_t expect[TEST_MAX_PRODUCERS];
+uint32_t producers = TEST_DEFAULT_PRODUCERS;
+uint32_t e, id, i;
+uint64_t received = 0, total, t0;
+size_t errors = 0;
+
+    if ( argc > 1 )
+    {
+        producers = strtoul(argv[1], NULL, 0);
+    }
+    if ( argc > 2 )
+    {
+        testCount = strtoul(argv[2], NULL, 0);
+    }
+    if ( (0 == producers) || (producers > TEST_MAX_PRODUCERS) || (testCount > 0x1000000UL) )
+    {
+        fprintf(stderr, "usage: %s [producers(1~%u)] [count(<=%lu)]\n",
+                argv[0], (unsigned)TEST_MAX_PRODUCERS, 0x1000000UL);
+        return (2);
+    }
+    INIT_MPSC_FIFO(&testFifo);
+    for ( i = 0; i < producers; i++ )
+    {
+        expect[i] = 0;
+    }
+    total = (uint64_t)producers*testCount;
+    t0 = bench_Nanoseconds();
+    for ( i = 0; i < producers; i++ )
+    {
+        pthread_create(&threads[i], NULL, prvProducer, (void *)(uintptr_t)i);
+    }
+    /*主线程作为唯一消费者*/
+    while ( received < total )
+    {
+        if ( !fifo_MpscOut(&testFifo, &e) )
+        {
+            /*生产者全部结束后FIFO仍为空, 说明有元素丢失*/
+            if ( (producers == __atomic_load_n(&testDoneCount, __ATOMIC_ACQUIRE)) &&
+                 fifo_MpscIsEmpty(&testFifo) )
+            {
+                fprintf(stderr, "%lu elements lost\n", (unsigned long)(total - received));
+                errors++;
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        received++;
+        id = TEST_ELEMENT_ID(e);
+        if ( (id >= producers) || (TEST_ELEMENT_SEQ(e) != expect[id]) )
+        {
+            if ( errors++ < 10 )
+            {
+                fprintf(stderr, "element %lu: got producer %u seq %u, expect seq %u\n",
+                        (unsigned long)received, (unsigned)id, (unsigned)TEST_ELEMENT_SEQ(e),
+                        (id < producers) ? (unsigned)expect[id] : 0U);
+            }
+            if ( id >= producers )
+            {
+                continue;
+            }
+        }
+        expect[id] = TEST_ELEMENT_SEQ(e) + 1;
+    }
+    for ( i = 0; i < producers; i++ )
+    {
+        pthread_join(threads[i], NULL);
+    }
+    if ( !fifo_MpscIsEmpty(&testFifo) )
+    {
+        fprintf(stderr, "fifo not empty after all elements received\n");
+        errors++;
+    }
+    printf("mpsc: %u producers x %u elements, %lu full retries, %.1f ms, %s\n",
+           (unsigned)producers, (unsigned)testCount, (unsigned long)testFullCount,
+           (double)(bench_Nanoseconds() - t0)/1e6, (0 == errors) ? "PASS" : "FAIL");
+    return ( (0 == errors) ? 0 : 1 );
+}
@@ -0,0 +1,228 @@
+/*******************************************************************************
+* 文 件 名: test_tickless.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 低功耗空闲(节拍抑制)模型检验, 随机启动/停止定时器, 按
+*           wheel_NextExpiry()模拟睡眠定时器并以wheel_Skip()跳过节拍,
+*           与逐节拍检查全部定时器的参考模型比较到期结果
+*******************************************************************************/
+
+#include "cpulib_wheel.h"
+#include "host_bench.h"
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+#define TEST_TIMERS                 ( 64 )
+#define TEST_DEFAULT_STEPS          ( 200000 )
+
+/*时间轮覆盖的节拍数*/
+#define __TEST_WHEEL_RANGE          ( (tick_t)1 << (WHEEL_SLOT_BITS*WHEEL_LEVELS) )
+/*随机延时上限, 超过时间轮覆盖范围以检验暂存于最高层的定时器*/
+#define TEST_DELAY_MAX              ( 3*__TEST_WHEEL_RANGE/2 )
+#define TEST_PERIOD_MAX             ( __TEST_WHEEL_RANGE )
+
+/*检查条件, 不成立时打印当前节拍及错误信息并计数*/
+#define TEST_CHECK(expr, ...)   do                                          \
+{                                                                           \
+    if ( !(expr) )                                                          \
+    {                                                                       \
+        if ( errors++ < 10 )                                                \
+        {                                                                   \
+            fprintf(stderr, "tick %lu: ", (unsigned long)modelNow);         \
+            fprintf(stderr, __VA_ARGS__);                                   \
+            fprintf(stderr, "\n");                                          \
+        }                                                                   \
+    }                                                                       \
+} while (0)
+
+/*******************************************************************************
+
+                                    数据类型
+
+*******************************************************************************/
+/*参考模型中的定时器*/
+typedef struct
+{
+    bool        active;
+    tick_t      expire;
+    tick_t      period;
+    uint32_t    fired;
+} ModelTimer_t;
+
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+static TimeWheel_t testWheel;
+static WheelTimer_t testTimers[TEST_TIMERS];
+static uint32_t testFired[TEST_TIMERS];
+static ModelTimer_t model[TEST_TIMERS];
+static tick_t modelNow;
+static size_t errors;
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+static void prvHandler(WheelTimer_t *timer)
+{
+    testFired[timer - testTimers]++;
+}
+
+/*参考模型: 距离最近一个定时器到期的节拍数, 没有启动的定时器时返回0*/
+static tick_t prvModelNext(void)
+{
+tick_t next = 0, delta;
+uint32_t i;
+
+    for ( i = 0; i < TEST_TIMERS; i++ )
+    {
+        if ( model[i].active )
+        {
+            delta = model[i].expire - modelNow;
+            if ( (0 == next) || (delta < next) )
+            {
+                next = delta;
+            }
+        }
+    }
+    return (next);
+}
+
+/*参考模型: 处理一个节拍, 逐个检查全部定时器*/
+static void prvModelTick(void)
+{
+uint32_t i;
+
+    modelNow++;
+    for ( i = 0; i < TEST_TIMERS; i++ )
+    {
+        if ( model[i].active && (model[i].expire == modelNow) )
+        {
+            model[i].fired++;
+            if ( 0 != model[i].period )
+            {
+                model[i].expire += model[i].period;
+            }
+            else
+            {
+                model[i].active = false;
+            }
+        }
+    }
+}
+
+/*比较时间轮与参考模型的状态*/
+static void prvCompare(void)
+{
+uint32_t i;
+
+    TEST_CHECK(testWheel.now == modelNow, "wheel now %lu", (unsigned long)testWheel.now);
+    for ( i = 0; i < TEST_TIMERS; i++ )
+    {
+        TEST_CHECK(testFired[i] == model[i].fired, "timer %u fired %u, expect %u",
+                   (unsigned)i, (unsigned)testFired[i], (unsigned)model[i].fired);
+        TEST_CHECK(wheel_IsActive(&testTimers[i]) == model[i].active, "timer %u active %d, expect %d",
+                   (unsigned)i, (int)wheel_IsActive(&testTimers[i]), (int)model[i].active);
+    }
+}
+
+/*
+ * 模拟一次低功耗空闲: 按wheel_NextExpiry()设置睡眠定时器, 随机提前被其他
+ * 中断唤醒, 醒来后跳过已睡眠的节拍并处理当前节拍
+ */
+static void prvIdle(uint64_t *slept)
+{
+tick_t next = wheel_NextExpiry(&testWheel);
+tick_t due  = prvModelNext();
+tick_t sleep;
+
+    TEST_CHECK(next >= 1, "next expiry %lu", (unsigned long)next);
+    TEST_CHECK((0 == due) || (next <= due), "next expiry %lu after due timer %lu",
+               (unsigned long)next, (unsigned long)due);
+    TEST_CHECK(next <= __TEST_WHEEL_RANGE, "next expiry %lu beyond wheel range", (unsigned long)next);
+    if ( (next < 1) || ((0 != due) && (next > due)) )
+    {
+        return;
+    }
+    sleep = (0 == bench_Rand()%4) ? bench_Rand()%next : next - 1;
+    if ( 0 != sleep )
+    {
+        wheel_Skip(&testWheel, sleep);
+        modelNow += sleep;
+        *slept += sleep;
+    }
+    wheel_Tick(&testWheel);
+    prvModelTick();
+}
+
+/*******************************************************************************
+
+                                     主函数
+
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+uint32_t steps = TEST_DEFAULT_STEPS, step, i, op;
+uint64_t slept = 0, idles = 0;
+tick_t delay, period;
+
+    if ( argc > 1 )
+    {
+        steps = strtoul(argv[1], NULL, 0);
+    }
+    bench_Seed(0x2545F491UL);
+    wheel_Init(&testWheel);
+    for ( i = 0; i < TEST_TIMERS; i++ )
+    {
+        wheel_TimerInit(&testTimers[i], prvHandler);
+    }
+    for ( step = 0; step < steps; step++ )
+    {
+        i  = bench_Rand()%TEST_TIMERS;
+        op = bench_Rand()%16;
+        if ( op < 4 )
+        {
+            /*启动一个未启动的定时器, 单次或周期*/
+            if ( !model[i].active )
+            {
+                delay  = 1 + bench_Rand()%TEST_DELAY_MAX;
+                period = (0 == bench_Rand()%2) ? 0 : 1 + bench_Rand()%TEST_PERIOD_MAX;
+                wheel_Add(&testWheel, &testTimers[i], delay, period);
+                model[i].active = true;
+                model[i].expire = modelNow + delay;
+                model[i].period = period;
+            }
+        }
+        else if ( op < 6 )
+        {
+            TEST_CHECK(wheel_Del(&testTimers[i]) == model[i].active, "timer %u del", (unsigned)i);
+            model[i].active = false;
+        }
+        else if ( op < 8 )
+        {
+            /*不进入低功耗空闲, 正常处理一个节拍*/
+            wheel_Tick(&testWheel);
+            prvModelTick();
+        }
+        else
+        {
+            prvIdle(&slept);
+            idles++;
+        }
+        prvCompare();
+        if ( 0 != errors )
+        {
+            break;
+        }
+    }
+    printf("tickless: %u steps, %lu ticks, %lu idles skipped %lu ticks, %s\n",
+           (unsigned)step, (unsigned long)modelNow, (unsigned long)idles,
+           (unsigned long)slept, (0 == errors) ? "PASS" : "FAIL");
+    return ( (0 == errors) ? 0 : 1 );
+}
@@ -0,0 +1,248 @@
+/*******************************************************************************
+* 文 件 名: cpulib_arena.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 线性(bump)内存分配, 支持标记与整体释放
+*******************************************************************************/
+
+#include "cpulib_arena.h"
+/*******************************************************************************
+
+                                    数据结构
+
+*******************************************************************************/
+/*Arena首部记录*/
+typedef struct arena_head ArenaHead_t;
+struct arena_head
+{
+    uint8_t        *pStart;                 /*可分配内存起始地址  */
+    uint8_t        *pEnd;                   /*可分配内存结束地址  */
+    uint8_t        *pCurrent;               /*当前分配位置        */
+    HeapDev_t      *pParent;                /*来源Heap, 可为NULL  */
+    size_t          totalSize;              /*Arena内存总大小     */
+    size_t          minimumEverFreeSize;    /*Arena内存最小剩余量 */
+};
+
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+/*
+ * 对指定的内存大小, 进行字节对齐处理
+ * size:   给定的内存大小
+ * return: 字节对齐后的大小
+ */
+#define __ARENA_GET_SIZE_ALIGNED(size)  \
+    ( ((size_t)(size) + (size_t)HEAP_BYTE_ALIGNMENT_MASK) & (~((size_t)HEAP_BYTE_ALIGNMENT_MASK)) )
+
+/*Arena首部结构体大小*/
+#define __ARENA_HEAD_STRUCT_SIZE        __ARENA_GET_SIZE_ALIGNED(sizeof(ArenaHead_t))
+
+/*******************************************************************************
+
+                                 Arena操作函数
+
+*******************************************************************************/
+/**
+ * 在指定内存上创建Arena设备
+ *
+ * @param startAddr: Arena内存起始地址
+ *
+ * @param totalSize: Arena内存总大小
+ *
+ * @return: 若创建成功, 返回Arena设备指针
+ *          若创建失败, 返回NULL
+ */
+ArenaDev_t *arena_Create( uint8_t *startAddr, size_t totalSize )
+{
+ArenaHead_t *pArena = NULL;
+size_t offset;
+
+    offset = (size_t)( (0 - (size_t)startAddr) & (size_t)HEAP_BYTE_ALIGNMENT_MASK );
+    if ( totalSize <= offset + __ARENA_HEAD_STRUCT_SIZE )
+    {
+        pArena = NULL;
+    }
+    else
+    {
+        pArena = (ArenaHead_t *)(startAddr + offset);
+        pArena->pStart    = startAddr + offset + __ARENA_HEAD_STRUCT_SIZE;
+        pArena->pEnd      = startAddr + totalSize;
+        pArena->pCurrent  = pArena->pStart;
+        pArena->pParent   = NULL;
+        pArena->totalSize = totalSize;
+        pArena->minimumEverFreeSize = (size_t)(pArena->pEnd - pArena->pStart);
+    }
+    return (pArena);
+}
+
+/**
+ * 从Heap中分配内存并创建Arena设备
+ *
+ * @param heap: 提供内存的Heap设备指针
+ *
+ * @param totalSize: Arena内存总大小(含Arena首部)
+ *
+ * @return: 若创建成功, 返回Arena设备指针, 使用arena_Destroy()归还内存
+ *          若创建失败, 返回NULL
+ */
+ArenaDev_t *arena_CreateFromHeap( HeapDev_t *heap, size_t totalSize )
+{
+ArenaHead_t *pArena = NULL;
+uint8_t *pMem;
+
+    debug_assert(NULL != heap);
+    pMem = (uint8_t *)heap_Malloc(heap, totalSize);
+    if ( NULL != pMem )
+    {
+        pArena = (ArenaHead_t *)arena_Create(pMem, totalSize);
+        if ( NULL == pArena )
+        {
+            heap_Free(heap, pMem);
+        }
+        else
+        {
+            debug_assert((uint8_t *)pArena == pMem);
+            pArena->pParent = heap;
+        }
+    }
+    return (pArena);
+}
+
+/**
+ * 销毁Arena设备, 若Arena由arena_CreateFromHeap()创建, 将内存归还给Heap
+ *
+ * @param arena: Arena设备指针
+ */
+void arena_Destroy( ArenaDev_t *arena )
+{
+ArenaHead_t *pArena;
+
+    if ( NULL != arena )
+    {
+        pArena = (ArenaHead_t *)arena;
+        if ( NULL != pArena->pParent )
+        {
+            heap_Free(pArena->pParent, pArena);
+        }
+    }
+}
+
+/**
+ * 获取Arena设备信息
+ *
+ * @param arena: Arena设备指针
+ *
+ * @param info: 保存设备信息的结构体指针, freeBlocks固定为1(剩余内存总是连续的)
+ */
+void arena_GetInfo( ArenaDev_t *arena, HeapInfo_t *info )
+{
+ArenaHead_t *pArena;
+
+    /*参数检验*/
+    debug_assert(NULL != arena);
+    debug_assert(NULL != info);
+    pArena = (ArenaHead_t *)arena;
+    info->totalSize  = pArena->totalSize;
+    info->freeSize   = (size_t)(pArena->pEnd - pArena->pCurrent);
+    info->minimumEverFreeSize = pArena->minimumEverFreeSize;
+    info->freeBlocks = 1;
+    info->reallocInPlace = 0;
+    info->reallocMerged  = 0;
+    info->reallocMoved   = 0;
+}
+
+/*******************************************************************************
+
+                                  内存分配函数
+
+*******************************************************************************/
+/**
+ * 从Arena中分配内存, 内存只能通过arena_Release()/arena_Reset()整体释放
+ *
+ * @param arena: Arena设备指针
+ *
+ * @param size: 分配内存的大小
+ *
+ * @return: 若分配成功, 返回按HEAP_BYTE_ALIGNMENT对齐的内存起始地址,
+ *          若剩余空间不足, 返回NULL
+ */
+void *arena_Alloc( ArenaDev_t *arena, size_t size )
+{
+void *pRet = NULL;
+ArenaHead_t *pArena;
+size_t freeSize;
+
+    /*参数检验*/
+    debug_assert(NULL != arena);
+    pArena   = (ArenaHead_t *)arena;
+    size     = __ARENA_GET_SIZE_ALIGNED(size);
+    freeSize = (size_t)(pArena->pEnd - pArena->pCurrent);
+    if ( (0 == size) || (size > freeSize) )
+    {
+        pRet = NULL;
+    }
+    else
+    {
+        pRet = pArena->pCurrent;
+        pArena->pCurrent += size;
+        freeSize -= size;
+        if ( pArena->minimumEverFreeSize > freeSize )
+        {
+            pArena->minimumEverFreeSize = freeSize;
+        }
+    }
+    return (pRet);
+}
+
+/**
+ * 获取Arena当前分配位置标记
+ *
+ * @param arena: Arena设备指针
+ *
+ * @return: 返回分配位置标记, 用于arena_Release()
+ */
+ArenaMark_t arena_GetMark( ArenaDev_t *arena )
+{
+ArenaHead_t *pArena;
+
+    debug_assert(NULL != arena);
+    pArena = (ArenaHead_t *)arena;
+    return ( (ArenaMark_t)(pArena->pCurrent - pArena->pStart) );
+}
+
+/**
+ * 释放标记之后分配的全部内存, 时间复杂度O(1)
+ *
+ * @param arena: Arena设备指针
+ *
+ * @param mark: 由arena_GetMark()获取的分配位置标记
+ */
+void arena_Release( ArenaDev_t *arena, ArenaMark_t mark )
+{
+ArenaHead_t *pArena;
+
+    debug_assert(NULL != arena);
+    pArena = (ArenaHead_t *)arena;
+    debug_assert(pArena->pStart + mark <= pArena->pCurrent);
+    if ( pArena->pStart + mark <= pArena->pCurrent )
+    {
+        pArena->pCurrent = pArena->pStart + mark;
+    }
+}
+
+/**
+ * 释放Arena中已分配的全部内存, 时间复杂度O(1)
+ *
+ * @param arena: Arena设备指针
+ */
+void arena_Reset( ArenaDev_t *arena )
+{
+ArenaHead_t *pArena;
+
+    debug_assert(NULL != arena);
+    pArena = (ArenaHead_t *)arena;
+    pArena->pCurrent = pArena->pStart;
+}
@@ -0,0 +1,204 @@
+/*******************************************************************************
+* 文 件 名: cpulib_dbuf.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 双缓冲(多缓冲), 用于DMA等块数据流
+*******************************************************************************/
+
+#include "cpulib_dbuf.h"
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+/*缓冲区状态*/
+#define __DBUF_FREE                 ( 0 )   /*空闲, 等待生产者填充  */
+#define __DBUF_FILLING              ( 1 )   /*生产者正在填充        */
+#define __DBUF_READY                ( 2 )   /*已填满, 等待消费者获取*/
+#define __DBUF_BUSY                 ( 3 )   /*消费者正在处理        */
+
+/*
+ * 获取下一个缓冲区序号
+ * pDBuf:  多缓冲对象指针
+ * index:  缓冲区序号
+ * return: 下一个缓冲区序号
+ */
+#define __DBUF_NEXT(pDBuf, index)   \
+    ( (uint8_t)(((index) + 1 < (pDBuf)->count) ? ((index) + 1) : 0) )
+
+/*******************************************************************************
+
+                                    操作函数
+
+*******************************************************************************/
+/**
+ * 初始化多缓冲对象, 生产者从第0个缓冲区开始填充
+ *
+ * @param pdbuf: 多缓冲对象指针
+ *
+ * @param mem: 存储地址, 大小为bufSize*count, 可直接作为循环模式DMA的存储区
+ *
+ * @param bufSize: 单个缓冲区大小
+ *
+ * @param count: 缓冲区数量, 2..DBUF_MAX_COUNT
+ */
+void dbuf_Init( DBuf_t *pdbuf, void *mem, size_t bufSize, uint8_t count )
+{
+uint8_t i;
+
+    debug_assert((2 <= count) && (count <= DBUF_MAX_COUNT));
+    pdbuf->data    = (uint8_t *)mem;
+    pdbuf->bufSize = bufSize;
+    pdbuf->count   = count;
+    pdbuf->fill    = 0;
+    pdbuf->next    = 0;
+    pdbuf->overrun = 0;
+    pdbuf->state[0] = __DBUF_FILLING;
+    for ( i = 1; i < count; i++ )
+    {
+        pdbuf->state[i] = __DBUF_FREE;
+    }
+}
+
+/**
+ * 获取溢出次数
+ *
+ * @param pdbuf: 多缓冲对象指针
+ *
+ * @return: 返回生产者覆盖未处理数据的次数
+ */
+size_t dbuf_GetOverrun( DBuf_t *pdbuf )
+{
+    return (pdbuf->overrun);
+}
+
+/**
+ * 获取生产者正在填充的缓冲区
+ *
+ * @param pdbuf: 多缓冲对象指针
+ *
+ * @return: 返回缓冲区地址
+ */
+void *dbuf_GetFillBuffer( DBuf_t *pdbuf )
+{
+    return ( pdbuf->data + pdbuf->fill*pdbuf->bufSize );
+}
+
+/**
+ * 生产者填满当前缓冲区, 交给消费者, 并开始填充下一个缓冲区
+ *
+ * @param pdbuf: 多缓冲对象指针
+ *
+ * @note: 下一个缓冲区尚未被消费者获取时, 丢弃其中最早的数据;
+ *        正被消费者处理时, 其数据被覆盖, 消费者归还时返回false;
+ *        两种情况均记为一次溢出
+ *
+ * @return: 返回下一个填充的缓冲区地址, 非循环模式DMA可据此重新配置
+ */
+void *dbuf_ProducerDone( DBuf_t *pdbuf )
+{
+uint8_t fill;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCriticalFromISR();
+    {
+        pdbuf->state[pdbuf->fill] = __DBUF_READY;
+        fill = __DBUF_NEXT(pdbuf, pdbuf->fill);
+        if ( __DBUF_READY == pdbuf->state[fill] )
+        {
+            /*最早填满的缓冲区未被获取, 消费者跳过该缓冲区*/
+            debug_assert(fill == pdbuf->next);
+            pdbuf->next = __DBUF_NEXT(pdbuf, fill);
+            pdbuf->overrun++;
+        }
+        else if ( __DBUF_BUSY == pdbuf->state[fill] )
+        {
+            pdbuf->overrun++;
+        }
+        pdbuf->state[fill] = __DBUF_FILLING;
+        pdbuf->fill = fill;
+    }
+    CPU_ExitCriticalFromISR(cpu_sr);
+    return ( pdbuf->data + fill*pdbuf->bufSize );
+}
+
+/**
+ * 循环模式DMA半传输回调, 双缓冲时第0个缓冲区填满
+ *
+ * @param pdbuf: 多缓冲对象指针, 须包含2个缓冲区且与DMA存储区重合
+ */
+void dbuf_OnHalfTransfer( DBuf_t *pdbuf )
+{
+    debug_assert(2 == pdbuf->count);
+    debug_assert(0 == pdbuf->fill);
+    dbuf_ProducerDone(pdbuf);
+}
+
+/**
+ * 循环模式DMA传输完成回调, 双缓冲时第1个缓冲区填满
+ *
+ * @param pdbuf: 多缓冲对象指针, 须包含2个缓冲区且与DMA存储区重合
+ */
+void dbuf_OnTransferComplete( DBuf_t *pdbuf )
+{
+    debug_assert(2 == pdbuf->count);
+    debug_assert(1 == pdbuf->fill);
+    dbuf_ProducerDone(pdbuf);
+}
+
+/**
+ * 消费者获取最早填满的缓冲区, 处理完毕后调用dbuf_Release()归还
+ *
+ * @param pdbuf: 多缓冲对象指针
+ *
+ * @return: 若有填满的缓冲区, 返回其地址, 所有权转移给消费者,
+ *          若没有, 返回NULL
+ */
+void *dbuf_Acquire( DBuf_t *pdbuf )
+{
+uint8_t *pRet = NULL;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        if ( __DBUF_READY == pdbuf->state[pdbuf->next] )
+        {
+            pdbuf->state[pdbuf->next] = __DBUF_BUSY;
+            pRet = pdbuf->data + pdbuf->next*pdbuf->bufSize;
+            pdbuf->next = __DBUF_NEXT(pdbuf, pdbuf->next);
+        }
+    }
+    CPU_ExitCritical(cpu_sr);
+    return (pRet);
+}
+
+/**
+ * 消费者归还缓冲区, 所有权交还给生产者
+ *
+ * @param pdbuf: 多缓冲对象指针
+ *
+ * @param buffer: 由dbuf_Acquire()获取的缓冲区地址
+ *
+ * @return: 返回布尔值, true表示处理期间数据完整,
+ *          false表示处理期间生产者已进入该缓冲区, 数据可能已被覆盖
+ */
+bool dbuf_Release( DBuf_t *pdbuf, void *buffer )
+{
+uint8_t index;
+bool ret = false;
+cpu_t cpu_sr;
+
+    index = (uint8_t)( ((uint8_t *)buffer - pdbuf->data) / pdbuf->bufSize );
+    debug_assert(index < pdbuf->count);
+    cpu_sr = CPU_EnterCritical();
+    {
+        if ( __DBUF_BUSY == pdbuf->state[index] )
+        {
+            pdbuf->state[index] = __DBUF_FREE;
+            ret = true;
+        }
+    }
+    CPU_ExitCritical(cpu_sr);
+    return (ret);
+}
@@ -8,26 +8,37 @@
 
 #include "cpulib_fifo.h"
 #include <string.h>
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+static FifoTickHook_t fifoTickHook = NULL;
+static FifoIdleHook_t fifoIdleHook = NULL;
+
 /*******************************************************************************
 
                                     私有函数
 
 *******************************************************************************/
 /**
- * FIFO进队列内容复制
+ * 环形缓冲区写入内容复制
  *
- * @param pFIFO: FIFO指针
+ * @param data: 环形缓冲区存储地址
  *
- * @param src: 进队列源内存地址
+ * @param esize: 元素大小
  *
- * @param len: 进队列元素长度
+ * @param total: 环形缓冲区总元素数
+ *
+ * @param off: 写入起始位置(元素)
+ *
+ * @param src: 写入源内存地址
+ *
+ * @param len: 写入元素长度
  */
-static void prvFifoCopyIn(struct __fifo *pFIFO, const void *src, size_t len)
+static void prvRingCopyIn(void *data, size_t esize, size_t total, size_t off, const void *src, size_t len)
 {
-uint8_t *dest = (uint8_t *)(pFIFO->data);
-size_t esize  = pFIFO->esize;
-size_t total  = pFIFO->total;
-size_t off    = pFIFO->in;
+uint8_t *dest = (uint8_t *)data;
 size_t l;
 
     if ( 1 != esize )
@@ -42,20 +53,23 @@ size_t l;
 }
 
 /**
- * FIFO出队列内容复制
+ * 环形缓冲区读出内容复制
  *
- * @param pFIFO: FIFO指针
+ * @param data: 环形缓冲区存储地址
  *
- * @param dest: 出队列目标内存地址
+ * @param esize: 元素大小
  *
- * @param len: 出队列元素长度
+ * @param total: 环形缓冲区总元素数
+ *
+ * @param off: 读出起始位置(元素)
+ *
+ * @param dest: 读出目标内存地址
+ *
+ * @param len: 读出元素长度
  */
-static void prvFifoCopyOut(struct __fifo *pFIFO, void *dest, size_t len)
+static void prvRingCopyOut(const void *data, size_t esize, size_t total, size_t off, void *dest, size_t len)
 {
-uint8_t const *src = (uint8_t *)(pFIFO->data);
-size_t esize = pFIFO->esize;
-size_t total = pFIFO->total;
-size_t off   = pFIFO->out;
+uint8_t const *src = (uint8_t const *)data;
 size_t l;
 
     if ( 1 != esize )
@@ -69,6 +83,85 @@ size_t l;
     memcpy((uint8_t *)dest + l, src, len - l);
 }
 
+/**
+ * 环形缓冲区元素查找
+ *
+ * @param data: 环形缓冲区存储地址
+ *
+ * @param esize: 元素大小
+ *
+ * @param total: 环形缓冲区总元素数
+ *
+ * @param off: 查找起始位置(元素)
+ *
+ * @param len: 查找元素长度
+ *
+ * @param element: 待查找的元素地址
+ *
+ * @return: 返回找到的元素相对于起始位置的偏移, 未找到返回FIFO_NOT_FOUND
+ */
+static size_t prvRingSearch(const void *data, size_t esize, size_t total, size_t off, size_t len, const void *element)
+{
+uint8_t const *src = (uint8_t const *)data;
+uint8_t const *pFound;
+size_t l, i;
+
+    l = ( (total - off) < len ) ? (total - off) : len;
+    if ( 1 == esize )
+    {
+        /*单字节元素使用memchr, 分别查找回绕前后两段*/
+        pFound = (uint8_t const *)memchr(src + off, *(uint8_t const *)element, l);
+        if ( NULL != pFound )
+        {
+            return ( (size_t)(pFound - (src + off)) );
+        }
+        pFound = (uint8_t const *)memchr(src, *(uint8_t const *)element, len - l);
+        if ( NULL != pFound )
+        {
+            return ( l + (size_t)(pFound - src) );
+        }
+    }
+    else
+    {
+        for ( i = 0; i < len; i++ )
+        {
+            if ( 0 == memcmp(src + ((i < l) ? (off + i) : (i - l))*esize, element, esize) )
+            {
+                return (i);
+            }
+        }
+    }
+    return (FIFO_NOT_FOUND);
+}
+
+/**
+ * FIFO进队列内容复制
+ *
+ * @param pFIFO: FIFO指针
+ *
+ * @param src: 进队列源内存地址
+ *
+ * @param len: 进队列元素长度
+ */
+static void prvFifoCopyIn(struct __fifo *pFIFO, const void *src, size_t len)
+{
+    prvRingCopyIn(pFIFO->data, pFIFO->esize, pFIFO->total, pFIFO->in, src, len);
+}
+
+/**
+ * FIFO出队列内容复制
+ *
+ * @param pFIFO: FIFO指针
+ *
+ * @param dest: 出队列目标内存地址
+ *
+ * @param len: 出队列元素长度
+ */
+static void prvFifoCopyOut(struct __fifo *pFIFO, void *dest, size_t len)
+{
+    prvRingCopyOut(pFIFO->data, pFIFO->esize, pFIFO->total, pFIFO->out, dest, len);
+}
+
 /*******************************************************************************
 
                                     操作函数
@@ -86,6 +179,7 @@ struct __fifo *pFIFO = (struct __fifo *)pfifo;
     pFIFO->in    = 0;
     pFIFO->out   = 0;
     pFIFO->count = 0;
+    pFIFO->dropped = 0;
 }
 
 /**
@@ -110,7 +204,7 @@ struct __fifo *pFIFO = (struct __fifo *)pfifo;
     prvFifoCopyIn(pFIFO,buffer,len);
     pFIFO->count += len;
     pFIFO->in += len;
-    if ( (pFIFO->in > pFIFO->total) || (pFIFO->in < len) )
+    if ( (pFIFO->in >= pFIFO->total) || (pFIFO->in < len) )
     {
         pFIFO->in -= pFIFO->total;
         debug_assert(pFIFO->in < pFIFO->total);
@@ -140,7 +234,7 @@ struct __fifo *pFIFO = (struct __fifo *)pfifo;
     prvFifoCopyOut(pFIFO,buffer,len);
     pFIFO->count -= len;
     pFIFO->out += len;
-    if ( (pFIFO->out > pFIFO->total) || (pFIFO->out < len) )
+    if ( (pFIFO->out >= pFIFO->total) || (pFIFO->out < len) )
     {
         pFIFO->out -= pFIFO->total;
         debug_assert(pFIFO->out < pFIFO->total);
@@ -171,6 +265,69 @@ struct __fifo *pFIFO = (struct __fifo *)pfifo;
     return (len);
 }
 
+/**
+ * FIFO覆盖进队列, FIFO剩余空间不足时丢弃最早进队列的元素
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @param buffer: 保存进队列元素的缓存地址
+ *
+ * @len: 进队列的元素个数, 超过FIFO总元素数时仅保留最后的total个元素
+ *
+ * @note: 使用CPU_EnterCritical()保护, 可以在中断函数和线程函数中调用;
+ *        生产者位于中断函数时, 消费者的出队列操作同样需要临界区保护;
+ *        丢弃的元素个数累加到fifo_GetDropped()
+ *
+ * @return: 返回成功进队列的元素个数
+ */
+size_t fifo_InOverwrite( FIFO_t *pfifo, const void *buffer, size_t len )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+size_t drop;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        /*跳过缓存中无法保留的较早元素*/
+        if ( len > pFIFO->total )
+        {
+            drop    = len - pFIFO->total;
+            buffer  = (const uint8_t *)buffer + drop*pFIFO->esize;
+            len     = pFIFO->total;
+            pFIFO->dropped += drop;
+        }
+        /*读索引前移, 丢弃最早进队列的元素*/
+        if ( len > (pFIFO->total - pFIFO->count) )
+        {
+            drop = len - (pFIFO->total - pFIFO->count);
+            pFIFO->count -= drop;
+            pFIFO->out += drop;
+            if ( (pFIFO->out >= pFIFO->total) || (pFIFO->out < drop) )
+            {
+                pFIFO->out -= pFIFO->total;
+            }
+            pFIFO->dropped += drop;
+        }
+        len = fifo_In(pfifo, buffer, len);
+    }
+    CPU_ExitCritical(cpu_sr);
+    return (len);
+}
+
+/**
+ * 获取FIFO因覆盖进队列而丢弃的元素个数
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @return: 返回自初始化或重置以来丢弃的元素个数
+ */
+size_t fifo_GetDropped( FIFO_t *pfifo )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+
+    return (pFIFO->dropped);
+}
+
 /**
  * 判断FIFO是否为空
  *
@@ -258,3 +415,809 @@ struct __fifo *pFIFO = (struct __fifo *)pfifo;
 
     return (pFIFO->total - pFIFO->count);
 }
+
+/*******************************************************************************
+
+                                 随机访问函数
+
+*******************************************************************************/
+/**
+ * 从指定偏移处读取FIFO元素, 但不进行出队列操作
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @param offset: 相对于下一个出队列元素的偏移
+ *
+ * @param buffer: 保存读取结果的缓存地址
+ *
+ * @len: 要读取的元素个数, 不一定能够全部成功读取
+ *
+ * @return: 返回成功读取的元素个数, 不超过len
+ */
+size_t fifo_PeekAt( FIFO_t *pfifo, size_t offset, void *buffer, size_t len )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+size_t off;
+
+    if ( offset >= pFIFO->count )
+    {
+        return (0);
+    }
+    if ( len > pFIFO->count - offset )
+    {
+        len = pFIFO->count - offset;
+    }
+    off = ( offset < pFIFO->total - pFIFO->out ) ? (pFIFO->out + offset) : (offset - (pFIFO->total - pFIFO->out));
+    prvRingCopyOut(pFIFO->data, pFIFO->esize, pFIFO->total, off, buffer, len);
+    return (len);
+}
+
+/**
+ * 丢弃FIFO出队列元素, 不复制内容
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @len: 要丢弃的元素个数, 不一定能够全部丢弃
+ *
+ * @return: 返回丢弃的元素个数, 不超过len
+ */
+size_t fifo_Skip( FIFO_t *pfifo, size_t len )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+
+    if ( len > pFIFO->count )
+    {
+        len = pFIFO->count;
+    }
+    fifo_OutConsume(pfifo, len);
+    return (len);
+}
+
+/**
+ * 从指定偏移处开始查找FIFO中与给定元素相同的元素, 查找可跨越存储区末尾
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @param offset: 查找起始位置, 相对于下一个出队列元素的偏移
+ *
+ * @param element: 待查找的元素地址, 按元素大小逐字节比较
+ *
+ * @return: 返回找到的元素相对于下一个出队列元素的偏移, 未找到返回FIFO_NOT_FOUND
+ */
+size_t fifo_Search( FIFO_t *pfifo, size_t offset, const void *element )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+size_t off, ret;
+
+    if ( offset >= pFIFO->count )
+    {
+        return (FIFO_NOT_FOUND);
+    }
+    off = ( offset < pFIFO->total - pFIFO->out ) ? (pFIFO->out + offset) : (offset - (pFIFO->total - pFIFO->out));
+    ret = prvRingSearch(pFIFO->data, pFIFO->esize, pFIFO->total, off, pFIFO->count - offset, element);
+    return ( (FIFO_NOT_FOUND == ret) ? FIFO_NOT_FOUND : (ret + offset) );
+}
+
+/**
+ * 从指定偏移处读取SPSC FIFO元素, 但不进行出队列操作, 仅由消费者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param offset: 相对于下一个出队列元素的偏移
+ *
+ * @param buffer: 保存读取结果的缓存地址
+ *
+ * @len: 要读取的元素个数, 不一定能够全部成功读取
+ *
+ * @return: 返回成功读取的元素个数, 不超过len
+ */
+size_t fifo_SpscPeekAt( SPSC_FIFO_t *pfifo, size_t offset, void *buffer, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in    = pFIFO->in;
+size_t out   = pFIFO->out;
+size_t count = in - out;
+
+    /*写索引先于存储内容读取*/
+    CPU_DMB();
+    if ( offset >= count )
+    {
+        return (0);
+    }
+    if ( len > count - offset )
+    {
+        len = count - offset;
+    }
+    prvRingCopyOut(pFIFO->data, pFIFO->esize, pFIFO->mask + 1, (out + offset) & pFIFO->mask, buffer, len);
+    return (len);
+}
+
+/**
+ * 丢弃SPSC FIFO出队列元素, 不复制内容, 仅由消费者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @len: 要丢弃的元素个数, 不一定能够全部丢弃
+ *
+ * @return: 返回丢弃的元素个数, 不超过len
+ */
+size_t fifo_SpscSkip( SPSC_FIFO_t *pfifo, size_t len )
+{
+size_t count = fifo_SpscGetCount(pfifo);
+
+    if ( len > count )
+    {
+        len = count;
+    }
+    fifo_SpscOutConsume(pfifo, len);
+    return (len);
+}
+
+/**
+ * 从指定偏移处开始查找SPSC FIFO中与给定元素相同的元素, 仅由消费者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param offset: 查找起始位置, 相对于下一个出队列元素的偏移
+ *
+ * @param element: 待查找的元素地址, 按元素大小逐字节比较
+ *
+ * @return: 返回找到的元素相对于下一个出队列元素的偏移, 未找到返回FIFO_NOT_FOUND
+ */
+size_t fifo_SpscSearch( SPSC_FIFO_t *pfifo, size_t offset, const void *element )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in    = pFIFO->in;
+size_t out   = pFIFO->out;
+size_t count = in - out;
+size_t ret;
+
+    /*写索引先于存储内容读取*/
+    CPU_DMB();
+    if ( offset >= count )
+    {
+        return (FIFO_NOT_FOUND);
+    }
+    ret = prvRingSearch(pFIFO->data, pFIFO->esize, pFIFO->mask + 1, (out + offset) & pFIFO->mask, count - offset, element);
+    return ( (FIFO_NOT_FOUND == ret) ? FIFO_NOT_FOUND : (ret + offset) );
+}
+
+/*******************************************************************************
+
+                                 MPSC FIFO操作函数
+
+*******************************************************************************/
+/**
+ * MPSC FIFO进队列一个元素, 可由多个生产者(包括相互嵌套的中断函数)同时调用
+ *
+ * @param pfifo: MPSC FIFO指针
+ *
+ * @param element: 进队列元素地址
+ *
+ * @note: 位置序号等于写索引时位置空闲, 预留成功后写入元素, 再将序号置为写索引+1
+ *
+ * @return: 返回布尔值, true表示进队列成功, false表示FIFO已满
+ */
+bool fifo_MpscIn( MPSC_FIFO_t *pfifo, const void *element )
+{
+struct __mpsc_fifo *pFIFO = (struct __mpsc_fifo *)pfifo;
+size_t pos, seq;
+
+    /*竞争预留写索引处的位置*/
+    pos = pFIFO->in;
+    for ( ;; )
+    {
+        seq = pFIFO->seq[pos & pFIFO->mask];
+        if ( seq == pos )
+        {
+            if ( cpu_AtomicCAS(&pFIFO->in, pos, pos + 1) )
+            {
+                break;
+            }
+            pos = pFIFO->in;
+        }
+        else if ( (ptrdiff_t)(seq - pos) < 0 )
+        {
+            /*位置尚未被消费者取走*/
+            return (false);
+        }
+        else
+        {
+            /*其他生产者已预留该位置*/
+            pos = pFIFO->in;
+        }
+    }
+    CPU_DMB();
+    memcpy((uint8_t *)(pFIFO->data) + (pos & pFIFO->mask)*pFIFO->esize, element, pFIFO->esize);
+    /*元素写入先于序号发布*/
+    CPU_DMB();
+    pFIFO->seq[pos & pFIFO->mask] = pos + 1;
+    return (true);
+}
+
+/**
+ * MPSC FIFO出队列一个元素, 仅由消费者调用
+ *
+ * @param pfifo: MPSC FIFO指针
+ *
+ * @param element: 保存出队列元素的地址
+ *
+ * @note: 先预留的位置尚未写入完成时, 即使其后的位置已经就绪, 也视为FIFO为空
+ *
+ * @return: 返回布尔值, true表示出队列成功, false表示FIFO为空
+ */
+bool fifo_MpscOut( MPSC_FIFO_t *pfifo, void *element )
+{
+struct __mpsc_fifo *pFIFO = (struct __mpsc_fifo *)pfifo;
+size_t pos = pFIFO->out;
+
+    if ( pFIFO->seq[pos & pFIFO->mask] != pos + 1 )
+    {
+        return (false);
+    }
+    /*序号读取先于元素读取*/
+    CPU_DMB();
+    memcpy(element, (uint8_t *)(pFIFO->data) + (pos & pFIFO->mask)*pFIFO->esize, pFIFO->esize);
+    /*元素读取先于位置释放*/
+    CPU_DMB();
+    pFIFO->seq[pos & pFIFO->mask] = pos + pFIFO->mask + 1;
+    pFIFO->out = pos + 1;
+    return (true);
+}
+
+/**
+ * 判断MPSC FIFO是否没有就绪的元素, 仅由消费者调用
+ *
+ * @param pfifo: MPSC FIFO指针
+ *
+ * @return: 返回布尔值, true表示下一个出队列元素尚未就绪
+ */
+bool fifo_MpscIsEmpty( MPSC_FIFO_t *pfifo )
+{
+struct __mpsc_fifo *pFIFO = (struct __mpsc_fifo *)pfifo;
+size_t pos = pFIFO->out;
+
+    return ( pFIFO->seq[pos & pFIFO->mask] != pos + 1 );
+}
+
+/*******************************************************************************
+
+                                 阻塞FIFO操作函数
+
+*******************************************************************************/
+/**
+ * 设置阻塞FIFO的等待函数, 对全部阻塞FIFO有效
+ *
+ * @param getTick: 获取当前节拍计数的函数, 若为NULL, 有限超时按0处理
+ *
+ * @param idle: 等待期间调用的空闲函数, 若为NULL, 使用CPU_WFI()睡眠至下一个中断
+ */
+void fifo_SetWaitHooks( FifoTickHook_t getTick, FifoIdleHook_t idle )
+{
+    fifoTickHook = getTick;
+    fifoIdleHook = idle;
+}
+
+/**
+ * 初始化阻塞FIFO, 默认有数据时通知消费者, 有空间时通知生产者, 通知函数为NULL
+ *
+ * @param pwait: 阻塞FIFO指针
+ *
+ * @param pfifo: 已初始化的普通FIFO指针
+ */
+void fifo_WaitInit( FifoWait_t *pwait, FIFO_t *pfifo )
+{
+    pwait->fifo      = pfifo;
+    pwait->highWater = 1;
+    pwait->lowWater  = fifo_GetTotal(pfifo) - 1;
+    pwait->onData    = NULL;
+    pwait->onSpace   = NULL;
+    pwait->arg       = NULL;
+}
+
+/**
+ * 设置阻塞FIFO的水位及通知函数
+ *
+ * @param pwait: 阻塞FIFO指针
+ *
+ * @param highWater: 数据水位, 已使用量由低于该值升至不低于该值时调用onData
+ *
+ * @param onData: 数据通知函数, 可为NULL
+ *
+ * @param lowWater: 空间水位, 已使用量由高于该值降至不高于该值时调用onSpace
+ *
+ * @param onSpace: 空间通知函数, 可为NULL
+ *
+ * @param arg: 通知函数参数
+ *
+ * @note: 通知函数在进/出队列的调用者上下文中(可能为中断函数)执行
+ */
+void fifo_WaitSetWatermark( FifoWait_t *pwait, size_t highWater, FifoNotify_t onData,
+                            size_t lowWater, FifoNotify_t onSpace, void *arg )
+{
+    debug_assert((0 < highWater) && (highWater <= fifo_GetTotal(pwait->fifo)));
+    debug_assert(lowWater < fifo_GetTotal(pwait->fifo));
+    pwait->highWater = highWater;
+    pwait->lowWater  = lowWater;
+    pwait->onData    = onData;
+    pwait->onSpace   = onSpace;
+    pwait->arg       = arg;
+}
+
+/**
+ * 阻塞FIFO进队列, 空间不足时等待消费者出队列
+ *
+ * @param pwait: 阻塞FIFO指针
+ *
+ * @param buffer: 保存进队列元素的缓存地址
+ *
+ * @len: 进队列的元素个数
+ *
+ * @param timeout: 超时节拍数, 为0时不等待(可在中断函数中调用), FIFO_WAIT_FOREVER表示无限等待
+ *                 未设置节拍函数时, 有限超时按0处理
+ *
+ * @return: 返回成功进队列的元素个数, 超时返回时小于len
+ */
+size_t fifo_InWait( FifoWait_t *pwait, const void *buffer, size_t len, tick_t timeout )
+{
+struct __fifo *pFIFO = (struct __fifo *)(pwait->fifo);
+tick_t start = 0;
+size_t done = 0;
+size_t n, before;
+bool notify;
+cpu_t cpu_sr;
+
+    if ( (NULL == fifoTickHook) && (FIFO_WAIT_FOREVER != timeout) )
+    {
+        /*未设置节拍函数时无法计时, 有限超时按不等待处理*/
+        timeout = 0;
+    }
+    if ( (0 != timeout) && (FIFO_WAIT_FOREVER != timeout) )
+    {
+        start = fifoTickHook();
+    }
+    for ( ;; )
+    {
+        cpu_sr = CPU_EnterCritical();
+        {
+            before = pFIFO->count;
+            n = fifo_In(pFIFO, (const uint8_t *)buffer + done*pFIFO->esize, len - done);
+            notify = (before < pwait->highWater) && (pFIFO->count >= pwait->highWater);
+        }
+        CPU_ExitCritical(cpu_sr);
+        done += n;
+        if ( notify && (NULL != pwait->onData) )
+        {
+            (pwait->onData)(pwait->arg);
+        }
+        if ( (done == len) || (0 == timeout) ||
+             ( (FIFO_WAIT_FOREVER != timeout) && ((tick_t)(fifoTickHook() - start) >= timeout) ) )
+        {
+            break;
+        }
+        if ( NULL != fifoIdleHook )
+        {
+            fifoIdleHook();
+        }
+        else
+        {
+            /*
+             * 关中断后再检查一次FIFO, 仍已满时在临界区内睡眠: 检查之后
+             * 到达的中断保持挂起, 仍会唤醒WFI, 不会丢失唤醒
+             */
+            cpu_sr = CPU_EnterCritical();
+            if ( pFIFO->count >= pFIFO->total )
+            {
+                CPU_WFI();
+            }
+            CPU_ExitCritical(cpu_sr);
+        }
+    }
+    return (done);
+}
+
+/**
+ * 阻塞FIFO出队列, 元素不足时等待生产者进队列
+ *
+ * @param pwait: 阻塞FIFO指针
+ *
+ * @param buffer: 保存出队列元素的缓存地址
+ *
+ * @len: 出队列的元素个数
+ *
+ * @param timeout: 超时节拍数, 为0时不等待(可在中断函数中调用), FIFO_WAIT_FOREVER表示无限等待
+ *                 未设置节拍函数时, 有限超时按0处理
+ *
+ * @return: 返回成功出队列的元素个数, 超时返回时小于len
+ */
+size_t fifo_OutWait( FifoWait_t *pwait, void *buffer, size_t len, tick_t timeout )
+{
+struct __fifo *pFIFO = (struct __fifo *)(pwait->fifo);
+tick_t start = 0;
+size_t done = 0;
+size_t n, before;
+bool notify;
+cpu_t cpu_sr;
+
+    if ( (NULL == fifoTickHook) && (FIFO_WAIT_FOREVER != timeout) )
+    {
+        /*未设置节拍函数时无法计时, 有限超时按不等待处理*/
+        timeout = 0;
+    }
+    if ( (0 != timeout) && (FIFO_WAIT_FOREVER != timeout) )
+    {
+        start = fifoTickHook();
+    }
+    for ( ;; )
+    {
+        cpu_sr = CPU_EnterCritical();
+        {
+            before = pFIFO->count;
+            n = fifo_Out(pFIFO, (uint8_t *)buffer + done*pFIFO->esize, len - done);
+            notify = (before > pwait->lowWater) && (pFIFO->count <= pwait->lowWater);
+        }
+        CPU_ExitCritical(cpu_sr);
+        done += n;
+        if ( notify && (NULL != pwait->onSpace) )
+        {
+            (pwait->onSpace)(pwait->arg);
+        }
+        if ( (done == len) || (0 == timeout) ||
+             ( (FIFO_WAIT_FOREVER != timeout) && ((tick_t)(fifoTickHook() - start) >= timeout) ) )
+        {
+            break;
+        }
+        if ( NULL != fifoIdleHook )
+        {
+            fifoIdleHook();
+        }
+        else
+        {
+            /*
+             * 关中断后再检查一次FIFO, 仍为空时在临界区内睡眠: 检查之后
+             * 到达的中断保持挂起, 仍会唤醒WFI, 不会丢失唤醒
+             */
+            cpu_sr = CPU_EnterCritical();
+            if ( 0 == pFIFO->count )
+            {
+                CPU_WFI();
+            }
+            CPU_ExitCritical(cpu_sr);
+        }
+    }
+    return (done);
+}
+
+/*******************************************************************************
+
+                                  零复制操作函数
+
+*******************************************************************************/
+/**
+ * 获取FIFO写索引处连续的可写存储区, 生产者直接写入后调用fifo_InCommit()
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @param len: 返回连续可写的元素个数, 为0表示FIFO已满
+ *
+ * @return: 返回可写存储区的起始地址
+ */
+void *fifo_InReserve( FIFO_t *pfifo, size_t *len )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+size_t off   = pFIFO->in;
+size_t avail = pFIFO->total - pFIFO->count;
+
+    *len = ( (pFIFO->total - off) < avail ) ? (pFIFO->total - off) : avail;
+    return ( (uint8_t *)(pFIFO->data) + off*pFIFO->esize );
+}
+
+/**
+ * 提交已写入可写存储区的元素, 完成进队列
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @param len: 提交的元素个数, 不超过fifo_InReserve()返回的长度
+ */
+void fifo_InCommit( FIFO_t *pfifo, size_t len )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+
+    debug_assert(len <= pFIFO->total - pFIFO->count);
+    pFIFO->count += len;
+    pFIFO->in += len;
+    if ( (pFIFO->in >= pFIFO->total) || (pFIFO->in < len) )
+    {
+        pFIFO->in -= pFIFO->total;
+        debug_assert(pFIFO->in < pFIFO->total);
+    }
+}
+
+/**
+ * 获取FIFO读索引处连续的可读存储区, 消费者直接读取后调用fifo_OutConsume()
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @param len: 返回连续可读的元素个数, 为0表示FIFO为空
+ *
+ * @return: 返回可读存储区的起始地址
+ */
+void *fifo_OutPeekLinear( FIFO_t *pfifo, size_t *len )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+size_t off = pFIFO->out;
+
+    *len = ( (pFIFO->total - off) < pFIFO->count ) ? (pFIFO->total - off) : pFIFO->count;
+    return ( (uint8_t *)(pFIFO->data) + off*pFIFO->esize );
+}
+
+/**
+ * 丢弃已读取的出队列元素, 完成出队列
+ *
+ * @param pfifo: FIFO指针
+ *
+ * @param len: 丢弃的元素个数, 不超过FIFO已经保存的元素个数
+ */
+void fifo_OutConsume( FIFO_t *pfifo, size_t len )
+{
+struct __fifo *pFIFO = (struct __fifo *)pfifo;
+
+    debug_assert(len <= pFIFO->count);
+    pFIFO->count -= len;
+    pFIFO->out += len;
+    if ( (pFIFO->out >= pFIFO->total) || (pFIFO->out < len) )
+    {
+        pFIFO->out -= pFIFO->total;
+        debug_assert(pFIFO->out < pFIFO->total);
+    }
+}
+
+/*******************************************************************************
+
+                                 SPSC FIFO操作函数
+
+*******************************************************************************/
+/**
+ * 重置SPSC FIFO, 须在生产者和消费者均未访问FIFO时调用
+ *
+ * @param pfifo: 待重置的SPSC FIFO指针
+ */
+void fifo_SpscReset( SPSC_FIFO_t *pfifo )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+
+    pFIFO->in  = 0;
+    pFIFO->out = 0;
+}
+
+/**
+ * SPSC FIFO进队列, 仅由生产者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param buffer: 保存进队列元素的缓存地址
+ *
+ * @len: 进队列的元素个数, 不一定能够全部成功进队列
+ *
+ * @return: 返回成功进队列的元素个数, 不超过len
+ */
+size_t fifo_SpscIn( SPSC_FIFO_t *pfifo, const void *buffer, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in    = pFIFO->in;
+size_t out   = pFIFO->out;
+size_t avail = pFIFO->mask + 1 - (in - out);
+
+    /*读索引先于存储内容读取, 保证消费者已取走的位置才被覆盖*/
+    CPU_DMB();
+    if ( len > avail )
+    {
+        len = avail;
+    }
+    prvRingCopyIn(pFIFO->data, pFIFO->esize, pFIFO->mask + 1, in & pFIFO->mask, buffer, len);
+    /*存储内容先于写索引更新, 保证消费者看到的元素已经写入*/
+    CPU_DMB();
+    pFIFO->in = in + len;
+    return (len);
+}
+
+/**
+ * SPSC FIFO出队列, 仅由消费者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param buffer: 保存出队列元素的缓存地址
+ *
+ * @len: 出队列的元素个数, 不一定能够全部成功出队列
+ *
+ * @return: 返回成功出队列的元素个数, 不超过len
+ */
+size_t fifo_SpscOut( SPSC_FIFO_t *pfifo, void *buffer, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t out = pFIFO->out;
+
+    len = fifo_SpscPeek(pfifo, buffer, len);
+    /*存储内容读取先于读索引更新, 保证生产者不会覆盖未读取的元素*/
+    CPU_DMB();
+    pFIFO->out = out + len;
+    return (len);
+}
+
+/**
+ * 读取SPSC FIFO出队列元素, 但不进行出队列操作, 仅由消费者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param buffer: 保存读取结果的缓存地址
+ *
+ * @len: 要读取的出队列元素个数, 不一定能够全部成功读取
+ *
+ * @return: 返回成功读取的元素个数, 不超过len
+ */
+size_t fifo_SpscPeek( SPSC_FIFO_t *pfifo, void *buffer, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in    = pFIFO->in;
+size_t out   = pFIFO->out;
+size_t count = in - out;
+
+    /*写索引先于存储内容读取, 保证读取的元素已经写入*/
+    CPU_DMB();
+    if ( len > count )
+    {
+        len = count;
+    }
+    prvRingCopyOut(pFIFO->data, pFIFO->esize, pFIFO->mask + 1, out & pFIFO->mask, buffer, len);
+    return (len);
+}
+
+/**
+ * 判断SPSC FIFO是否为空
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @return: 返回布尔值, true表示FIFO为空
+ */
+bool fifo_SpscIsEmpty( SPSC_FIFO_t *pfifo )
+{
+    return ( 0 == fifo_SpscGetCount(pfifo) );
+}
+
+/**
+ * 判断SPSC FIFO是否已满
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @return: 返回布尔值, true表示FIFO已满
+ */
+bool fifo_SpscIsFull( SPSC_FIFO_t *pfifo )
+{
+    return ( 0 == fifo_SpscGetAvail(pfifo) );
+}
+
+/**
+ * 获取SPSC FIFO已经保存的元素个数, 在另一方并发操作时仅为瞬时值
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @return: 返回FIFO已经保存的元素个数
+ */
+size_t fifo_SpscGetCount( SPSC_FIFO_t *pfifo )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t out = pFIFO->out;
+
+    return (pFIFO->in - out);
+}
+
+/**
+ * 获取SPSC FIFO总共可以保存的元素个数
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @return: 返回FIFO总共可以保存的元素个数
+ */
+size_t fifo_SpscGetTotal( SPSC_FIFO_t *pfifo )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+
+    return (pFIFO->mask + 1);
+}
+
+/**
+ * 获取SPSC FIFO剩余可以保存的元素个数, 在另一方并发操作时仅为瞬时值
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @return: 返回FIFO剩余可以保存的元素个数
+ */
+size_t fifo_SpscGetAvail( SPSC_FIFO_t *pfifo )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in = pFIFO->in;
+
+    return (pFIFO->mask + 1 - (in - pFIFO->out));
+}
+
+/**
+ * 获取SPSC FIFO写索引处连续的可写存储区, 仅由生产者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param len: 返回连续可写的元素个数, 为0表示FIFO已满
+ *
+ * @return: 返回可写存储区的起始地址
+ */
+void *fifo_SpscInReserve( SPSC_FIFO_t *pfifo, size_t *len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in    = pFIFO->in;
+size_t out   = pFIFO->out;
+size_t avail = pFIFO->mask + 1 - (in - out);
+size_t off   = in & pFIFO->mask;
+
+    /*读索引先于存储内容写入, 保证消费者已取走的位置才被覆盖*/
+    CPU_DMB();
+    *len = ( (pFIFO->mask + 1 - off) < avail ) ? (pFIFO->mask + 1 - off) : avail;
+    return ( (uint8_t *)(pFIFO->data) + off*pFIFO->esize );
+}
+
+/**
+ * 提交已写入可写存储区的元素, 仅由生产者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param len: 提交的元素个数, 不超过fifo_SpscInReserve()返回的长度
+ */
+void fifo_SpscInCommit( SPSC_FIFO_t *pfifo, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in = pFIFO->in;
+
+    debug_assert(len <= fifo_SpscGetAvail(pfifo));
+    /*存储内容先于写索引更新*/
+    CPU_DMB();
+    pFIFO->in = in + len;
+}
+
+/**
+ * 获取SPSC FIFO读索引处连续的可读存储区, 仅由消费者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param len: 返回连续可读的元素个数, 为0表示FIFO为空
+ *
+ * @return: 返回可读存储区的起始地址
+ */
+void *fifo_SpscOutPeekLinear( SPSC_FIFO_t *pfifo, size_t *len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t in    = pFIFO->in;
+size_t out   = pFIFO->out;
+size_t count = in - out;
+size_t off   = out & pFIFO->mask;
+
+    /*写索引先于存储内容读取, 保证读取的元素已经写入*/
+    CPU_DMB();
+    *len = ( (pFIFO->mask + 1 - off) < count ) ? (pFIFO->mask + 1 - off) : count;
+    return ( (uint8_t *)(pFIFO->data) + off*pFIFO->esize );
+}
+
+/**
+ * 丢弃已读取的出队列元素, 仅由消费者调用
+ *
+ * @param pfifo: SPSC FIFO指针
+ *
+ * @param len: 丢弃的元素个数, 不超过FIFO已经保存的元素个数
+ */
+void fifo_SpscOutConsume( SPSC_FIFO_t *pfifo, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;
+size_t out = pFIFO->out;
+
+    debug_assert(len <= fifo_SpscGetCount(pfifo));
+    /*存储内容读取先于读索引更新*/
+    CPU_DMB();
+    pFIFO->out = out + len;
+}
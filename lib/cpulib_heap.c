@@ -13,22 +13,73 @@
                                     数据结构
 
 *******************************************************************************/
+/*Heap公共首部, 位于各算法Heap首部的起始位置*/
+typedef struct heap_ctrl HeapCtrl_t;
+struct heap_ctrl
+{
+    HeapAlgo_t      algo;                   /*Heap分配算法        */
+    size_t          totalSize;              /*Heap内存总大小      */
+    size_t          freeSize;               /*Heap未分配内存大小  */
+    size_t          minimumEverFreeSize;    /*Heap内存最小剩余量  */
+    size_t          reallocInPlace;         /*realloc原地完成次数 */
+    size_t          reallocMerged;          /*realloc前向合并次数 */
+    size_t          reallocMoved;           /*realloc复制移动次数 */
+    bool            isrSafe;                /*是否为中断安全模式  */
+    volatile bool   busy;                   /*Heap正在被操作      */
+    volatile size_t deferredFree;           /*延迟释放链表首地址  */
+#if HEAP_USE_TRACE
+    HeapTraceEvent_t   *pTraceBuffer;       /*追踪缓冲区, NULL表示未启动*/
+    size_t              traceSize;          /*追踪缓冲区容量      */
+    size_t              traceIndex;         /*下一事件写入位置    */
+    size_t              traceCount;         /*累计事件数量        */
+#endif
+};
+
 /*Heap内存块*/
 typedef struct heap_block HeapBlock_t;
 struct heap_block
 {
     HeapBlock_t    *pNextFreeBlock;
     size_t          blockSize;
+#if HEAP_USE_BOUNDARY_TAG
+    HeapBlock_t    *pPrevFreeBlock;         /*空闲链表前驱, 仅空闲块有效*/
+#endif
 };
 /*Heap首部记录*/
 typedef struct heap_head HeapHead_t;
 struct heap_head
 {
+    HeapCtrl_t      ctrl;                   /*Heap公共首部        */
     HeapBlock_t     startBlock;             /*Heap空闲内存块链表头*/
     HeapBlock_t    *pEndBlock;              /*Heap空闲内存块尾结点*/
-    size_t          totalSize;              /*Heap内存总大小      */
-    size_t          freeSize;               /*Heap未分配内存大小  */
-    size_t          minimumEverFreeSize;    /*Heap内存最小剩余量  */
+};
+
+/*TLSF内存块*/
+typedef struct tlsf_block TlsfBlock_t;
+struct tlsf_block
+{
+    TlsfBlock_t    *pPrevPhysBlock;         /*物理相邻的前一内存块*/
+    size_t          blockSize;              /*内存块大小(含首部)  */
+    TlsfBlock_t    *pNextFreeBlock;         /*空闲链表后继, 仅空闲块有效*/
+    TlsfBlock_t    *pPrevFreeBlock;         /*空闲链表前驱, 仅空闲块有效*/
+};
+
+/*多区域Heap的区域记录*/
+typedef struct heap_region_entry HeapRegionEntry_t;
+struct heap_region_entry
+{
+    HeapDev_t      *pHeap;                  /*区域内的子Heap      */
+    uint8_t        *pStart;                 /*区域起始地址        */
+    uint8_t        *pEnd;                   /*区域结束地址        */
+    uint8_t         attr;                   /*区域属性            */
+};
+/*多区域Heap首部记录*/
+typedef struct heap_regions_head HeapRegionsHead_t;
+struct heap_regions_head
+{
+    HeapCtrl_t          ctrl;               /*Heap公共首部        */
+    size_t              regionCount;        /*区域数量            */
+    HeapRegionEntry_t   regions[];          /*区域记录表          */
 };
 
 /*******************************************************************************
@@ -77,6 +128,65 @@ const size_t _cs = (size_t)(pSrc);                                          \
                     );                                                      \
 } while(0)
 
+/*
+ * 记录分配/释放追踪事件, 须在公共操作函数内直接展开, 以取得调用者地址
+ * heap:   Heap设备指针
+ * ptr:    内存地址
+ * size:   请求大小
+ */
+#if HEAP_USE_TRACE
+    #define __HEAP_TRACE_MALLOC(heap,ptr,size)  \
+        prvTraceRecord((HeapCtrl_t *)(heap), CPU_RETURN_ADDRESS(), (ptr), (size) & (~HEAP_TRACE_FREE))
+    #define __HEAP_TRACE_FREE(heap,ptr)         \
+        prvTraceRecord((HeapCtrl_t *)(heap), CPU_RETURN_ADDRESS(), (ptr), HEAP_TRACE_FREE)
+#else
+    #define __HEAP_TRACE_MALLOC(heap,ptr,size)  ((void)0)
+    #define __HEAP_TRACE_FREE(heap,ptr)         ((void)0)
+#endif
+
+/*TLSF字节对齐位数*/
+#if   ( HEAP_BYTE_ALIGNMENT == 1 )
+    #define __TLSF_ALIGN_SIZE_LOG2      ( 0 )
+#elif ( HEAP_BYTE_ALIGNMENT == 2 )
+    #define __TLSF_ALIGN_SIZE_LOG2      ( 1 )
+#elif ( HEAP_BYTE_ALIGNMENT == 4 )
+    #define __TLSF_ALIGN_SIZE_LOG2      ( 2 )
+#elif ( HEAP_BYTE_ALIGNMENT == 8 )
+    #define __TLSF_ALIGN_SIZE_LOG2      ( 3 )
+#else
+    #error "HEAP_BYTE_ALIGNMENT must be 1, 2, 4 or 8"
+#endif
+
+#if ( HEAP_TLSF_SL_INDEX_COUNT_LOG2 > 4 )
+    #error "HEAP_TLSF_SL_INDEX_COUNT_LOG2 must not be greater than 4"
+#endif
+
+/*
+ * TLSF索引参数
+ * 小于__TLSF_SMALL_BLOCK_SIZE的内存块全部归入一级索引0, 按对齐粒度线性划分二级索引;
+ * 其余内存块的一级索引由最高有效位决定, 二级索引由最高位之后的若干位决定
+ */
+#define __TLSF_SL_INDEX_COUNT           ( 1 << HEAP_TLSF_SL_INDEX_COUNT_LOG2 )
+#define __TLSF_FL_INDEX_SHIFT           ( HEAP_TLSF_SL_INDEX_COUNT_LOG2 + __TLSF_ALIGN_SIZE_LOG2 )
+#define __TLSF_FL_INDEX_COUNT           ( HEAP_TLSF_FL_INDEX_MAX - __TLSF_FL_INDEX_SHIFT + 2 )
+#define __TLSF_SMALL_BLOCK_SIZE         ( (size_t)1 << __TLSF_FL_INDEX_SHIFT )
+
+#if ( __TLSF_FL_INDEX_COUNT > 32 ) || ( HEAP_TLSF_FL_INDEX_MAX < __TLSF_FL_INDEX_SHIFT )
+    #error "HEAP_TLSF_FL_INDEX_MAX is out of range"
+#endif
+
+/*TLSF首部记录*/
+typedef struct tlsf_head TlsfHead_t;
+struct tlsf_head
+{
+    HeapCtrl_t      ctrl;                                           /*Heap公共首部  */
+    TlsfBlock_t    *pStartBlock;                                    /*首个内存块    */
+    TlsfBlock_t    *pEndBlock;                                      /*内存块尾结点  */
+    uint32_t        flBitmap;                                       /*一级索引位图  */
+    uint16_t        slBitmap[__TLSF_FL_INDEX_COUNT];                /*二级索引位图  */
+    TlsfBlock_t    *pFreeLists[__TLSF_FL_INDEX_COUNT][__TLSF_SL_INDEX_COUNT];   /*空闲链表*/
+};
+
 /*******************************************************************************
 
                                     常量定义
@@ -84,21 +194,80 @@ const size_t _cs = (size_t)(pSrc);                                          \
 *******************************************************************************/
 /*Heap首部结构体大小*/
 static const size_t HeapHeadStructSize    = __HEAP_GET_SIZE_ALIGNED(sizeof(HeapHead_t));
+#if HEAP_USE_BOUNDARY_TAG
+/*Heap内存块结构体大小, 空闲链表前驱仅在空闲块中有效, 不计入已分配块首部*/
+static const size_t HeapBlockStructSize   = __HEAP_GET_SIZE_ALIGNED(offsetof(HeapBlock_t, pPrevFreeBlock));
+/*Heap内存块尾部边界标记大小*/
+static const size_t HeapBlockTagSize      = sizeof(size_t);
+/*Heap首个内存块之前的边界标记占用大小*/
+static const size_t HeapBlockGuardSize    = __HEAP_GET_SIZE_ALIGNED(sizeof(size_t));
+#else
 /*Heap内存块结构体大小*/
 static const size_t HeapBlockStructSize   = __HEAP_GET_SIZE_ALIGNED(sizeof(HeapBlock_t));
+/*Heap内存块尾部边界标记大小*/
+static const size_t HeapBlockTagSize      = 0;
+/*Heap首个内存块之前的边界标记占用大小*/
+static const size_t HeapBlockGuardSize    = 0;
+/*已分配内存块的最小大小, 用户内存至少容纳一个指针*/
+static const size_t HeapMinimumAllocSize  = __HEAP_GET_SIZE_ALIGNED(sizeof(HeapBlock_t) + sizeof(void *));
+#endif
 /*Heap最小可分割内存块大小*/
-static const size_t HeapMinimumBlockSize  = 2 * __HEAP_GET_SIZE_ALIGNED(sizeof(HeapBlock_t));
+static const size_t HeapMinimumBlockSize  = 2 * HeapBlockStructSize;
 /*Heap内存块分配标志位*/
 static const size_t HeapBlockAllocatedBit = ((size_t)1) << (8*sizeof(size_t)-1);
 
+/*TLSF首部结构体大小*/
+static const size_t TlsfHeadStructSize    = __HEAP_GET_SIZE_ALIGNED(sizeof(TlsfHead_t));
+/*TLSF已分配内存块首部大小*/
+static const size_t TlsfBlockHeadSize     = __HEAP_GET_SIZE_ALIGNED(offsetof(TlsfBlock_t, pNextFreeBlock));
+/*TLSF最小内存块大小, 需容纳空闲链表指针*/
+static const size_t TlsfMinimumBlockSize  = __HEAP_GET_SIZE_ALIGNED(sizeof(TlsfBlock_t));
+/*TLSF可分配的最大内存块大小*/
+static const size_t TlsfMaximumAllocSize  = ((size_t)1) << HEAP_TLSF_FL_INDEX_MAX;
+
+static void prvCtrlInit(HeapCtrl_t *pCtrl, HeapAlgo_t algo, size_t totalSize);
+static bool prvLock(HeapCtrl_t *pCtrl, bool isFree);
+static void prvUnlock(HeapCtrl_t *pCtrl);
+static void prvDeferFree(HeapCtrl_t *pCtrl, void *ptr);
+static void *prvMalloc(HeapDev_t *heap, size_t size);
+static void prvFree(HeapDev_t *heap, void *ptr);
+static void prvGetFragmentation(HeapDev_t *heap, HeapFragInfo_t *info);
+static void prvFragAddBlock(HeapFragInfo_t *info, size_t blockSize);
+#if HEAP_USE_TRACE
+static void prvTraceRecord(HeapCtrl_t *pCtrl, void *caller, void *ptr, size_t size);
+#endif
+
+static HeapDev_t *prvFirstFitCreate(uint8_t *pAligned, size_t freeSize);
+static void *prvFirstFitMalloc(HeapHead_t *pHeap, size_t size);
+static void *prvFirstFitRealloc(HeapHead_t *pHeap, void *ptr, size_t size);
+static void *prvFirstFitMallocAligned(HeapHead_t *pHeap, size_t size, size_t alignment);
+static void prvFirstFitFree(HeapHead_t *pHeap, void *ptr);
+static void prvRemoveBlockFromFreeList(HeapHead_t *pHeap, HeapBlock_t *pPrevBlock, HeapBlock_t *pBlock);
 static void prvInsertBlockIntoFreeList(HeapHead_t *pHeap, HeapBlock_t *pBlockToInsert);
+STATIC_INLINE void prvSetBlockTag(HeapBlock_t *pBlock);
+#if HEAP_USE_BOUNDARY_TAG
+STATIC_INLINE size_t prvGetPrevBlockTag(HeapBlock_t *pBlock);
+#endif
+
+static HeapDev_t *prvTlsfCreate(uint8_t *pAligned, size_t freeSize);
+static void *prvTlsfMalloc(TlsfHead_t *pTlsf, size_t size);
+static void *prvTlsfRealloc(TlsfHead_t *pTlsf, void *ptr, size_t size);
+static void *prvTlsfMallocAligned(TlsfHead_t *pTlsf, size_t size, size_t alignment);
+static void prvTlsfFree(TlsfHead_t *pTlsf, void *ptr);
+static size_t prvTlsfCountFreeBlocks(TlsfHead_t *pTlsf);
+static void prvTlsfGetFragmentation(TlsfHead_t *pTlsf, HeapFragInfo_t *info);
+
+static size_t prvGetUsableSize(HeapCtrl_t *pCtrl, void *ptr);
+static HeapRegionEntry_t *prvRegionsFind(HeapRegionsHead_t *pRegions, void *ptr);
+static void *prvRegionsMalloc(HeapRegionsHead_t *pRegions, size_t size, uint8_t hint);
+static void *prvRegionsRealloc(HeapRegionsHead_t *pRegions, void *ptr, size_t size);
 /*******************************************************************************
 
                                   Heap操作函数
 
 *******************************************************************************/
 /**
- * 创建Heap设备
+ * 创建Heap设备, 使用首次适应算法
  *
  * @param startAddr: Heap内存起始地址
  *
@@ -109,8 +278,26 @@ static void prvInsertBlockIntoFreeList(HeapHead_t *pHeap, HeapBlock_t *pBlockToI
  */
 HeapDev_t *heap_Create( uint8_t *startAddr, size_t totalSize )
 {
-HeapHead_t  *pHeap = NULL;
-HeapBlock_t *pBlock;
+    return heap_CreateEx(startAddr, totalSize, HEAP_ALGO_FIRSTFIT);
+}
+
+/**
+ * 创建Heap设备, 并指定分配算法
+ *
+ * @param startAddr: Heap内存起始地址
+ *
+ * @param totalSize: Heap内存总大小
+ *
+ * @param algo: Heap分配算法,
+ *              HEAP_ALGO_FIRSTFIT: 首次适应算法, 内存开销小, 分配释放时间随碎片增长
+ *              HEAP_ALGO_TLSF:     两级分离适应算法, 首部较大, 分配释放时间有界
+ *
+ * @return: 若创建成功, 返回Heap设备指针
+ *          若创建失败, 返回NULL
+ */
+HeapDev_t *heap_CreateEx( uint8_t *startAddr, size_t totalSize, HeapAlgo_t algo )
+{
+HeapCtrl_t  *pCtrl = NULL;
 uint8_t     *pAligned;
 size_t       freeSize;
 
@@ -118,35 +305,96 @@ size_t       freeSize;
     freeSize = totalSize - ((size_t)pAligned - (size_t)startAddr);
     freeSize &= ~( (size_t)HEAP_BYTE_ALIGNMENT_MASK );
 
-    if  (   ( freeSize < (HeapHeadStructSize+HeapMinimumBlockSize+HeapBlockStructSize) ) ||
-            ( freeSize & HeapBlockAllocatedBit)
+    if (    ( totalSize < ((size_t)pAligned - (size_t)startAddr) ) ||
+            ( freeSize & HeapBlockAllocatedBit ) ||
+            ( HEAP_ALGO_REGIONS == algo )
         )
     {
-        pHeap = NULL;
+        pCtrl = NULL;
+    }
+    else if ( HEAP_ALGO_TLSF == algo )
+    {
+        pCtrl = (HeapCtrl_t *)prvTlsfCreate(pAligned, freeSize);
     }
     else
     {
-        /*分配Heap首部*/
-        pHeap = (HeapHead_t *)pAligned;
-        pAligned += HeapHeadStructSize;
-        freeSize -= HeapHeadStructSize;
-        /*分配内存块尾结点*/
-        freeSize -= HeapBlockStructSize;
-        pHeap->pEndBlock = (HeapBlock_t *)(pAligned + freeSize);
-        pHeap->pEndBlock->pNextFreeBlock = NULL;
-        pHeap->pEndBlock->blockSize = 0;
-        /*分配空闲内存块*/
-        pBlock = (HeapBlock_t *)pAligned;
-        pBlock->pNextFreeBlock = pHeap->pEndBlock;
-        pBlock->blockSize = freeSize;
-        /*初始化Heap首部*/
-        pHeap->startBlock.pNextFreeBlock = pBlock;
-        pHeap->startBlock.blockSize = 0;
-        pHeap->totalSize = totalSize;
-        pHeap->freeSize  = freeSize;
-        pHeap->minimumEverFreeSize = freeSize;
+        pCtrl = (HeapCtrl_t *)prvFirstFitCreate(pAligned, freeSize);
     }
-    return (pHeap);
+
+    if ( NULL != pCtrl )
+    {
+        prvCtrlInit(pCtrl, algo, totalSize);
+    }
+    return (pCtrl);
+}
+
+/**
+ * 创建由多个不连续内存区域组成的Heap设备
+ *
+ * @param regions: 内存区域描述表, 多区域Heap首部保存在第一个区域的起始位置
+ *
+ * @param count: 内存区域数量
+ *
+ * @param algo: 各区域使用的分配算法, HEAP_ALGO_FIRSTFIT或HEAP_ALGO_TLSF
+ *
+ * @note: heap_Malloc按区域表顺序分配, heap_MallocHint按属性优先选择区域,
+ *        heap_Free/heap_Realloc根据地址自动找到所属区域
+ *
+ * @return: 若创建成功, 返回Heap设备指针
+ *          若任一区域创建失败, 返回NULL
+ */
+HeapDev_t *heap_CreateRegions( const HeapRegion_t *regions, size_t count, HeapAlgo_t algo )
+{
+HeapRegionsHead_t *pRegions = NULL;
+HeapRegionEntry_t *pEntry;
+uint8_t *pAligned, *pStart;
+size_t headSize, offset, regionSize;
+size_t i;
+
+    /*参数检验*/
+    debug_assert(NULL != regions);
+    if ( (0 == count) || (HEAP_ALGO_REGIONS == algo) )
+    {
+        return (NULL);
+    }
+    __HEAP_SET_PTR_ALIGNED(pAligned, uint8_t *, regions[0].startAddr);
+    offset   = (size_t)pAligned - (size_t)regions[0].startAddr;
+    headSize = __HEAP_GET_SIZE_ALIGNED( sizeof(HeapRegionsHead_t) + count*sizeof(HeapRegionEntry_t) );
+    if ( regions[0].totalSize < (offset + headSize) )
+    {
+        return (NULL);
+    }
+
+    /*分配多区域Heap首部, 在各区域中创建子Heap*/
+    pRegions = (HeapRegionsHead_t *)pAligned;
+    pRegions->regionCount = count;
+    prvCtrlInit(&pRegions->ctrl, HEAP_ALGO_REGIONS, 0);
+    pRegions->ctrl.freeSize  = 0;
+    pRegions->ctrl.minimumEverFreeSize = 0;
+    for ( i = 0; i < count; i++ )
+    {
+        pEntry = &pRegions->regions[i];
+        if ( 0 == i )
+        {
+            pStart     = pAligned + headSize;
+            regionSize = regions[0].totalSize - offset - headSize;
+        }
+        else
+        {
+            pStart     = regions[i].startAddr;
+            regionSize = regions[i].totalSize;
+        }
+        pEntry->pHeap = heap_CreateEx(pStart, regionSize, algo);
+        if ( NULL == pEntry->pHeap )
+        {
+            return (NULL);
+        }
+        pEntry->pStart = pStart;
+        pEntry->pEnd   = pStart + regionSize;
+        pEntry->attr   = regions[i].attr;
+        pRegions->ctrl.totalSize += regions[i].totalSize;
+    }
+    return (pRegions);
 }
 
 /**
@@ -158,22 +406,146 @@ size_t       freeSize;
  */
 void heap_GetInfo( HeapDev_t *heap, HeapInfo_t *info )
 {
+HeapCtrl_t *pCtrl;
 HeapHead_t *pHeap;
 HeapBlock_t *pBlock;
+HeapRegionsHead_t *pRegions;
+HeapInfo_t regionInfo;
+size_t i;
+bool locked;
 
     /*参数检验*/
     debug_assert(NULL != heap);
     debug_assert(NULL != info);
-    pHeap = (HeapHead_t *)heap;
-    info->totalSize = pHeap->totalSize;
-    info->freeSize  = pHeap->freeSize;
-    info->minimumEverFreeSize = pHeap->minimumEverFreeSize;
-    for (   info->freeBlocks = 0, pBlock = pHeap->startBlock.pNextFreeBlock;
-            pBlock != pHeap->pEndBlock;
-            ++(info->freeBlocks), pBlock = pBlock->pNextFreeBlock
-        )
+    pCtrl = (HeapCtrl_t *)heap;
+    /*先获取操作权, 使统计包含已处理的延迟释放; Heap正被打断的上下文占用时, 不统计空闲块*/
+    locked = prvLock(pCtrl, false);
+    info->totalSize = pCtrl->totalSize;
+    info->freeSize  = pCtrl->freeSize;
+    info->minimumEverFreeSize = pCtrl->minimumEverFreeSize;
+    info->reallocInPlace = pCtrl->reallocInPlace;
+    info->reallocMerged  = pCtrl->reallocMerged;
+    info->reallocMoved   = pCtrl->reallocMoved;
+    info->freeBlocks     = 0;
+    if ( locked )
+    {
+        if ( HEAP_ALGO_REGIONS == pCtrl->algo )
+        {
+            /*累加各区域信息, 最小剩余量为各区域最小剩余量之和*/
+            pRegions = (HeapRegionsHead_t *)heap;
+            info->freeSize = 0;
+            info->minimumEverFreeSize = 0;
+            info->freeBlocks = 0;
+            for ( i = 0; i < pRegions->regionCount; i++ )
+            {
+                heap_GetInfo(pRegions->regions[i].pHeap, &regionInfo);
+                info->freeSize            += regionInfo.freeSize;
+                info->minimumEverFreeSize += regionInfo.minimumEverFreeSize;
+                info->freeBlocks          += regionInfo.freeBlocks;
+                info->reallocInPlace      += regionInfo.reallocInPlace;
+                info->reallocMerged       += regionInfo.reallocMerged;
+                info->reallocMoved        += regionInfo.reallocMoved;
+            }
+        }
+        else if ( HEAP_ALGO_TLSF == pCtrl->algo )
+        {
+            info->freeBlocks = prvTlsfCountFreeBlocks((TlsfHead_t *)heap);
+        }
+        else
+        {
+            pHeap = (HeapHead_t *)heap;
+            for (   info->freeBlocks = 0, pBlock = pHeap->startBlock.pNextFreeBlock;
+                    pBlock != pHeap->pEndBlock;
+                    ++(info->freeBlocks), pBlock = pBlock->pNextFreeBlock
+                )
+            {
+            }
+        }
+        prvUnlock(pCtrl);
+    }
+}
+
+/**
+ * 获取Heap设备的内存区域数量
+ *
+ * @param heap: Heap设备指针
+ *
+ * @return: 多区域Heap返回区域数量, 其余Heap返回1
+ */
+size_t heap_GetRegionCount( HeapDev_t *heap )
+{
+HeapCtrl_t *pCtrl;
+
+    debug_assert(NULL != heap);
+    pCtrl = (HeapCtrl_t *)heap;
+    if ( HEAP_ALGO_REGIONS == pCtrl->algo )
+    {
+        return ( ((HeapRegionsHead_t *)heap)->regionCount );
+    }
+    else
+    {
+        return (1);
+    }
+}
+
+/**
+ * 获取Heap设备中指定内存区域的信息
+ *
+ * @param heap: Heap设备指针
+ *
+ * @param index: 区域序号, 与创建时的区域表顺序一致
+ *
+ * @param info: 保存区域信息的结构体指针
+ *
+ * @return: 若区域存在返回true, 反之返回false
+ */
+bool heap_GetRegionInfo( HeapDev_t *heap, size_t index, HeapInfo_t *info )
+{
+HeapCtrl_t *pCtrl;
+HeapRegionsHead_t *pRegions;
+
+    debug_assert(NULL != heap);
+    debug_assert(NULL != info);
+    pCtrl = (HeapCtrl_t *)heap;
+    if ( HEAP_ALGO_REGIONS != pCtrl->algo )
+    {
+        if ( 0 != index )
+        {
+            return (false);
+        }
+        heap_GetInfo(heap, info);
+    }
+    else
     {
+        pRegions = (HeapRegionsHead_t *)heap;
+        if ( index >= pRegions->regionCount )
+        {
+            return (false);
+        }
+        heap_GetInfo(pRegions->regions[index].pHeap, info);
     }
+    return (true);
+}
+
+/**
+ * 设置Heap设备的中断安全模式
+ *
+ * @param heap: Heap设备指针
+ *
+ * @param isrSafe: 若为true, 各操作函数仅在获取/释放操作权时短暂进入临界区,
+ *                 内存分配与空闲链表遍历在中断使能的状态下进行
+ *
+ * @note: 中断中(cpu_InHandlerMode()为真)调用heap_Free只将内存块放入延迟释放链表,
+ *        下一次在线程中调用Heap函数时统一释放, 中断关闭的时间与Heap状态无关;
+ *        中断中分配内存时, 若Heap正被打断的线程操作, 立即返回NULL;
+ *        本模式不替代线程间互斥, 抢占式调度下由调用者保证线程间的互斥,
+ *        须在Heap空闲时设置
+ */
+void heap_SetIsrSafe( HeapDev_t *heap, bool isrSafe )
+{
+    debug_assert(NULL != heap);
+    debug_assert(!((HeapCtrl_t *)heap)->busy);
+    ((HeapCtrl_t *)heap)->isrSafe = isrSafe;
 }
 
 /*******************************************************************************
@@ -194,59 +566,59 @@ HeapBlock_t *pBlock;
 void *heap_Malloc( HeapDev_t *heap, size_t size )
 {
 void *pRet = NULL;
-HeapHead_t *pHeap;
-HeapBlock_t *pPrevBlock, *pNewBlock, *pBlock;
+
+    debug_assert(NULL != heap);
+    if ( prvLock((HeapCtrl_t *)heap, false) )
+    {
+        pRet = prvMalloc(heap, size);
+        __HEAP_TRACE_MALLOC(heap, pRet, size);
+        prvUnlock((HeapCtrl_t *)heap);
+    }
+    return (pRet);
+}
+
+/**
+ * 按位置提示分配内存
+ *
+ * @param heap: Heap设备指针
+ *
+ * @param size: 分配内存的大小
+ *
+ * @param hint: 位置提示, HEAP_REGION_ATTR_xxx的组合, 可附加HEAP_HINT_STRICT,
+ *              对于单区域Heap无作用
+ *
+ * @return: 若分配成功, 返回分配的内存起始地址,
+ *          若分配失败, 返回NULL
+ */
+void *heap_MallocHint( HeapDev_t *heap, size_t size, uint8_t hint )
+{
+void *pRet = NULL;
+HeapCtrl_t *pCtrl;
 
     /*参数检验*/
     debug_assert(NULL != heap);
-    pHeap = (HeapHead_t *)heap;
-    if ( (size == 0) || (size&HeapBlockAllocatedBit) )
+    pCtrl = (HeapCtrl_t *)heap;
+    if ( !prvLock(pCtrl, false) )
     {
         pRet = NULL;
     }
     else
     {
-        size += HeapBlockStructSize;
-        size  = __HEAP_GET_SIZE_ALIGNED(size);
-        if (size > pHeap->freeSize)
+        if ( HEAP_ALGO_REGIONS != pCtrl->algo )
+        {
+            pRet = prvMalloc(heap, size);
+        }
+        else if ( (size == 0) || (size&HeapBlockAllocatedBit) )
         {
             pRet = NULL;
         }
         else
         {
-            for (   pPrevBlock = &pHeap->startBlock, pBlock = pHeap->startBlock.pNextFreeBlock;
-                    (pBlock->blockSize < size) && (pBlock->pNextFreeBlock != NULL);
-                    pPrevBlock = pBlock, pBlock = pBlock->pNextFreeBlock
-                )
-            {
-            }
-            if ( pBlock != pHeap->pEndBlock )
-            {
-                pRet = (void *)( ((uint8_t *)pBlock) + HeapBlockStructSize );
-                pPrevBlock->pNextFreeBlock = pBlock->pNextFreeBlock;
-                /*分割Block*/
-                if ( (pBlock->blockSize - size) > HeapMinimumBlockSize )
-                {
-                    pNewBlock = (HeapBlock_t *)( ((uint8_t *)pBlock) + size );
-                    debug_assert(__HEAP_IS_PTR_ALIGNED(pNewBlock));
-                    pNewBlock->blockSize = pBlock->blockSize - size;
-                    pNewBlock->pNextFreeBlock = NULL;
-                    pBlock->blockSize = size;
-                    prvInsertBlockIntoFreeList(pHeap, pNewBlock);
-                }
-                /*更新Heap首部*/
-                pHeap->freeSize -= pBlock->blockSize;
-                if ( pHeap->minimumEverFreeSize > pHeap->freeSize )
-                {
-                    pHeap->minimumEverFreeSize = pHeap->freeSize;
-                }
-                /*标记已分配内存块*/
-                pBlock->pNextFreeBlock = NULL;
-                pBlock->blockSize |= HeapBlockAllocatedBit;
-            }
+            pRet = prvRegionsMalloc((HeapRegionsHead_t *)heap, size, hint);
         }
+        __HEAP_TRACE_MALLOC(heap, pRet, size);
+        prvUnlock(pCtrl);
     }
-    debug_assert(__HEAP_IS_PTR_ALIGNED(pRet));
     return (pRet);
 }
 
@@ -265,12 +637,24 @@ HeapBlock_t *pPrevBlock, *pNewBlock, *pBlock;
 void *heap_Calloc( HeapDev_t *heap, size_t nmemb, size_t size )
 {
 void *pRet = NULL;
-size_t totalSize = nmemb*size;
+size_t totalSize;
 
-    pRet = heap_Malloc(heap, totalSize);
+    debug_assert(NULL != heap);
+    /*nmemb*size溢出时分配失败*/
+    if ( (0 != size) && (nmemb > SIZE_MAX/size) )
+    {
+        return (NULL);
+    }
+    totalSize = nmemb*size;
+    if ( prvLock((HeapCtrl_t *)heap, false) )
+    {
+        pRet = prvMalloc(heap, totalSize);
+        __HEAP_TRACE_MALLOC(heap, pRet, totalSize);
+        prvUnlock((HeapCtrl_t *)heap);
+    }
     if ( NULL != pRet )
     {
-        memset(pRet, 0, size);
+        memset(pRet, 0, totalSize);
     }
     return (pRet);
 }
@@ -284,76 +668,64 @@ size_t totalSize = nmemb*size;
  *
  * @param size: 重新分配内存的大小, 若为0则等同于free
  *
+ * @note: 扩大内存时, 依次尝试吸收物理相邻的后一空闲块(原地完成),
+ *        吸收前一空闲块(数据前移), 最后才重新分配并复制数据
+ *
  * @return: 若分配成功, 返回重新分配的内存起始地址,
  *          若分配失败, 返回NULL
  */
 void *heap_Realloc( HeapDev_t *heap, void *ptr, size_t size )
 {
 void *pRet = NULL;
-HeapHead_t *pHeap;
-HeapBlock_t *pBlock, *pNewBlock;
-size_t wantedSize;
-size_t allocSize;
+HeapCtrl_t *pCtrl;
 
     /*参数检验*/
     debug_assert(NULL != heap);
-    pHeap = (HeapHead_t *)heap;
+    pCtrl = (HeapCtrl_t *)heap;
 
+    if ( !prvLock(pCtrl, (NULL != ptr) && (0 == size)) )
+    {
+        /*中断中的释放请求进入延迟释放链表, 其余请求失败*/
+        if ( (NULL != ptr) && (0 == size) )
+        {
+            prvDeferFree(pCtrl, ptr);
+        }
+        return (NULL);
+    }
     if (NULL == ptr)
     {
-        pRet = heap_Malloc(heap, size);
+        pRet = prvMalloc(heap, size);
     }
     else if (0 == size)
     {
-        heap_Free(heap, ptr);
+        prvFree(heap, ptr);
         pRet = NULL;
     }
     else if (size&HeapBlockAllocatedBit)
     {
         pRet = NULL;
     }
+    else if ( HEAP_ALGO_REGIONS == pCtrl->algo )
+    {
+        pRet = prvRegionsRealloc((HeapRegionsHead_t *)heap, ptr, size);
+    }
+    else if ( HEAP_ALGO_TLSF == pCtrl->algo )
+    {
+        pRet = prvTlsfRealloc((TlsfHead_t *)heap, ptr, size);
+    }
     else
     {
-        /*计算重新分配的内存大小*/
-        wantedSize  = size;
-        wantedSize += HeapBlockStructSize;
-        wantedSize  = __HEAP_GET_SIZE_ALIGNED(wantedSize);
-        /*获取原先已分配的内存大小*/
-        debug_assert(__HEAP_IS_PTR_ALIGNED(ptr));
-        debug_assert((uint8_t *)ptr > (uint8_t *)pHeap);
-        debug_assert((uint8_t *)ptr < (uint8_t *)(pHeap->pEndBlock));
-        pBlock = (HeapBlock_t *)( ((uint8_t *)ptr) - HeapBlockStructSize );
-        debug_assert(pBlock->blockSize & HeapBlockAllocatedBit);
-        debug_assert(pBlock->pNextFreeBlock == NULL);
-        allocSize   = pBlock->blockSize & (~HeapBlockAllocatedBit);
-        debug_assert(allocSize > HeapBlockStructSize);
-
-        if (wantedSize > allocSize)
-        {
-            /*重新分配内存*/
-            pRet = heap_Malloc(heap, size);
-            if (pRet != NULL)
-            {
-                memcpy(pRet,ptr,allocSize-HeapBlockStructSize);
-                heap_Free(heap, ptr);
-            }
-        }
-        else
-        {
-            /*分割原有内存*/
-            pRet = ptr;
-            if ( (allocSize-wantedSize) > HeapMinimumBlockSize )
-            {
-                pNewBlock = (HeapBlock_t *)( ((uint8_t *)pBlock) + wantedSize );
-                debug_assert(__HEAP_IS_PTR_ALIGNED(pNewBlock));
-                pNewBlock->blockSize = allocSize - wantedSize;
-                pNewBlock->pNextFreeBlock = NULL;
-                pBlock->blockSize = wantedSize | HeapBlockAllocatedBit;
-                pBlock->pNextFreeBlock = NULL;
-                prvInsertBlockIntoFreeList(pHeap, pNewBlock);
-            }
-        }
+        pRet = prvFirstFitRealloc((HeapHead_t *)heap, ptr, size);
+    }
+    if ( (NULL != ptr) && ((0 == size) || (NULL != pRet)) )
+    {
+        __HEAP_TRACE_FREE(heap, ptr);
+    }
+    if ( 0 != size )
+    {
+        __HEAP_TRACE_MALLOC(heap, pRet, size);
     }
+    prvUnlock(pCtrl);
     return (pRet);
 }
 
@@ -366,41 +738,893 @@ size_t allocSize;
  */
 void heap_Free( HeapDev_t *heap, void *ptr )
 {
-HeapHead_t *pHeap;
-HeapBlock_t *pBlock;
-
     if (NULL != ptr)
     {
-        /*参数检验*/
         debug_assert(NULL != heap);
-        pHeap = (HeapHead_t *)heap;
-        debug_assert((uint8_t *)ptr > (uint8_t *)pHeap);
-        debug_assert((uint8_t *)ptr < (uint8_t *)(pHeap->pEndBlock));
-        pBlock = (HeapBlock_t *)( ((uint8_t *)ptr) - HeapBlockStructSize );
-        debug_assert(pBlock->blockSize & HeapBlockAllocatedBit);
-        debug_assert(pBlock->pNextFreeBlock == NULL);
-        if ( pBlock->blockSize & HeapBlockAllocatedBit )
+        if ( prvLock((HeapCtrl_t *)heap, true) )
         {
-            if ( pBlock->pNextFreeBlock == NULL )
-            {
-                pBlock->blockSize &= ~HeapBlockAllocatedBit;
-                pHeap->freeSize += pBlock->blockSize;
-                prvInsertBlockIntoFreeList(pHeap, pBlock);
-            }
+            prvFree(heap, ptr);
+            __HEAP_TRACE_FREE(heap, ptr);
+            prvUnlock((HeapCtrl_t *)heap);
+        }
+        else
+        {
+            prvDeferFree((HeapCtrl_t *)heap, ptr);
         }
     }
 }
 
 /*******************************************************************************
 
-                                    私有函数
+                                对齐内存分配函数
 
 *******************************************************************************/
-/*将孤立的内存块重新插入到空闲内存块链表, 并完成相邻内存块合并*/
-static void prvInsertBlockIntoFreeList(HeapHead_t *pHeap, HeapBlock_t *pBlockToInsert)
+/**
+ * 按指定字节对齐分配内存, 适用于DMA缓存等对地址有特殊要求的场合
+ *
+ * @param heap: Heap设备指针
+ *
+ * @param size: 分配内存的大小
+ *
+ * @param alignment: 对齐字节数, 必须为2的幂, 不大于HEAP_BYTE_ALIGNMENT时等同于heap_Malloc
+ *
+ * @note: 直接从空闲内存块中截取满足对齐要求的部分, 前部剩余内存归还空闲链表,
+ *        对返回的内存调用heap_Realloc不保证维持对齐
+ *
+ * @return: 若分配成功, 返回对齐的内存起始地址,
+ *          若分配失败, 返回NULL
+ */
+void *heap_MallocAligned( HeapDev_t *heap, size_t size, size_t alignment )
 {
-HeapBlock_t *pSearch;
-uint8_t *puc;
+void *pRet = NULL;
+HeapCtrl_t *pCtrl;
+HeapRegionsHead_t *pRegions;
+size_t i;
+
+    /*参数检验*/
+    debug_assert(NULL != heap);
+    debug_assert( (0 != alignment) && (0 == (alignment & (alignment-1))) );
+    pCtrl = (HeapCtrl_t *)heap;
+    if (    ( size == 0 ) || ( size&HeapBlockAllocatedBit ) ||
+            ( alignment == 0 ) || ( 0 != (alignment & (alignment-1)) ) ||
+            ( alignment & HeapBlockAllocatedBit )
+        )
+    {
+        pRet = NULL;
+    }
+    else if ( prvLock(pCtrl, false) )
+    {
+        if ( alignment <= HEAP_BYTE_ALIGNMENT )
+        {
+            pRet = prvMalloc(heap, size);
+        }
+        else if ( HEAP_ALGO_REGIONS == pCtrl->algo )
+        {
+            pRegions = (HeapRegionsHead_t *)heap;
+            for ( i = 0; (i < pRegions->regionCount) && (NULL == pRet); i++ )
+            {
+                pRet = heap_MallocAligned(pRegions->regions[i].pHeap, size, alignment);
+            }
+        }
+        else if ( HEAP_ALGO_TLSF == pCtrl->algo )
+        {
+            pRet = prvTlsfMallocAligned((TlsfHead_t *)heap, size, alignment);
+        }
+        else
+        {
+            pRet = prvFirstFitMallocAligned((HeapHead_t *)heap, size, alignment);
+        }
+        __HEAP_TRACE_MALLOC(heap, pRet, size);
+        prvUnlock(pCtrl);
+    }
+    debug_assert(0 == ((size_t)pRet & (alignment-1)));
+    return (pRet);
+}
+
+/**
+ * 释放由heap_MallocAligned分配的内存
+ *
+ * @param heap: Heap设备指针
+ *
+ * @param ptr: 待释放的内存起始地址, 若为NULL则无动作
+ */
+void heap_FreeAligned( HeapDev_t *heap, void *ptr )
+{
+    /*对齐内存块的首部紧邻返回地址, 与普通内存块相同*/
+    if (NULL != ptr)
+    {
+        debug_assert(NULL != heap);
+        if ( prvLock((HeapCtrl_t *)heap, true) )
+        {
+            prvFree(heap, ptr);
+            __HEAP_TRACE_FREE(heap, ptr);
+            prvUnlock((HeapCtrl_t *)heap);
+        }
+        else
+        {
+            prvDeferFree((HeapCtrl_t *)heap, ptr);
+        }
+    }
+}
+
+/*******************************************************************************
+
+                                  碎片统计与追踪
+
+*******************************************************************************/
+/**
+ * 获取Heap空闲块的碎片信息
+ *
+ * @param heap: Heap设备指针
+ *
+ * @param info: 保存碎片信息的结构体指针
+ *
+ * @note: 需遍历全部空闲块(TLSF遍历全部内存块), 耗时与块数量成正比,
+ *        空闲块大小均包含块首部, 与heap_GetInfo的freeSize口径一致;
+ *        多区域Heap汇总各区域的统计
+ */
+void heap_GetFragmentation( HeapDev_t *heap, HeapFragInfo_t *info )
+{
+    /*参数检验*/
+    debug_assert(NULL != heap);
+    debug_assert(NULL != info);
+    memset(info, 0, sizeof(HeapFragInfo_t));
+    if ( prvLock((HeapCtrl_t *)heap, false) )
+    {
+        prvGetFragmentation(heap, info);
+        prvUnlock((HeapCtrl_t *)heap);
+    }
+}
+
+#if HEAP_USE_TRACE
+/**
+ * 启动Heap分配追踪
+ *
+ * @param heap: Heap设备指针
+ *
+ * @param buffer: 追踪事件环形缓冲区, 格式见HeapTraceEvent_t
+ *
+ * @param count: 缓冲区可容纳的事件数量
+ *
+ * @note: 重新启动时清零累计事件数量; 多区域Heap仅记录通过该设备的调用
+ */
+void heap_TraceStart( HeapDev_t *heap, HeapTraceEvent_t *buffer, size_t count )
+{
+HeapCtrl_t *pCtrl;
+
+    /*参数检验*/
+    debug_assert(NULL != heap);
+    debug_assert( (NULL != buffer) && (0 != count) );
+    pCtrl = (HeapCtrl_t *)heap;
+    pCtrl->traceSize  = count;
+    pCtrl->traceIndex = 0;
+    pCtrl->traceCount = 0;
+    pCtrl->pTraceBuffer = buffer;
+}
+
+/**
+ * 停止Heap分配追踪, 缓冲区内容保持不变, 可随后转储
+ *
+ * @param heap: Heap设备指针
+ */
+void heap_TraceStop( HeapDev_t *heap )
+{
+    debug_assert(NULL != heap);
+    ((HeapCtrl_t *)heap)->pTraceBuffer = NULL;
+}
+
+/**
+ * 获取自heap_TraceStart以来的累计事件数量
+ *
+ * @param heap: Heap设备指针
+ *
+ * @return: 累计事件数量, 超过缓冲区容量时最旧的事件已被覆盖
+ */
+size_t heap_TraceGetCount( HeapDev_t *heap )
+{
+    debug_assert(NULL != heap);
+    return ( ((HeapCtrl_t *)heap)->traceCount );
+}
+#endif  /* HEAP_USE_TRACE */
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/*初始化Heap公共首部*/
+static void prvCtrlInit(HeapCtrl_t *pCtrl, HeapAlgo_t algo, size_t totalSize)
+{
+    pCtrl->algo = algo;
+    pCtrl->totalSize = totalSize;
+    pCtrl->reallocInPlace = 0;
+    pCtrl->reallocMerged  = 0;
+    pCtrl->reallocMoved   = 0;
+    pCtrl->isrSafe = false;
+    pCtrl->busy    = false;
+    pCtrl->deferredFree = 0;
+#if HEAP_USE_TRACE
+    pCtrl->pTraceBuffer = NULL;
+    pCtrl->traceSize  = 0;
+    pCtrl->traceIndex = 0;
+    pCtrl->traceCount = 0;
+#endif
+}
+
+/*
+ * 获取Heap操作权, 非中断安全模式下总是成功
+ * isFree: 是否为释放请求, 中断中的释放请求不获取操作权, 转入延迟释放链表
+ * return: 获取成功返回true, 在线程中获取成功后先处理延迟释放链表
+ */
+static bool prvLock(HeapCtrl_t *pCtrl, bool isFree)
+{
+bool ret = true;
+cpu_t cpu_sr;
+size_t list;
+void *pList, *pNext;
+
+    if ( pCtrl->isrSafe )
+    {
+        if ( isFree && cpu_InHandlerMode() )
+        {
+            ret = false;
+        }
+        else
+        {
+            cpu_sr = CPU_EnterCritical();
+            ret = !pCtrl->busy;
+            pCtrl->busy = true;
+            CPU_ExitCritical(cpu_sr);
+        }
+        if ( ret && !cpu_InHandlerMode() )
+        {
+            /*原子地取走整个延迟释放链表*/
+            do
+            {
+                list = pCtrl->deferredFree;
+            } while ( (0 != list) && !cpu_AtomicCAS(&pCtrl->deferredFree, list, 0) );
+            pList = (void *)list;
+            for ( ; NULL != pList; pList = pNext )
+            {
+                pNext = *(void **)pList;
+                prvFree((HeapDev_t *)pCtrl, pList);
+#if HEAP_USE_TRACE
+                prvTraceRecord(pCtrl, NULL, pList, HEAP_TRACE_FREE);
+#endif
+            }
+        }
+    }
+    return (ret);
+}
+
+/*释放Heap操作权, 须与成功的prvLock配对*/
+static void prvUnlock(HeapCtrl_t *pCtrl)
+{
+    if ( pCtrl->isrSafe )
+    {
+        pCtrl->busy = false;
+    }
+}
+
+/*
+ * 将内存块无锁地压入延迟释放链表, 链表指针保存在用户内存中;
+ * 链表只会被整体取走, 不会单独弹出结点, 不存在ABA问题
+ */
+static void prvDeferFree(HeapCtrl_t *pCtrl, void *ptr)
+{
+size_t head;
+
+    do
+    {
+        head = pCtrl->deferredFree;
+        *(void **)ptr = (void *)head;
+    } while ( !cpu_AtomicCAS(&pCtrl->deferredFree, head, (size_t)ptr) );
+}
+
+/*按分配算法分发malloc, 不记录追踪事件*/
+static void *prvMalloc(HeapDev_t *heap, size_t size)
+{
+void *pRet = NULL;
+HeapCtrl_t *pCtrl;
+
+    /*参数检验*/
+    debug_assert(NULL != heap);
+    pCtrl = (HeapCtrl_t *)heap;
+    if ( (size == 0) || (size&HeapBlockAllocatedBit) )
+    {
+        pRet = NULL;
+    }
+    else if ( HEAP_ALGO_REGIONS == pCtrl->algo )
+    {
+        pRet = prvRegionsMalloc((HeapRegionsHead_t *)heap, size, HEAP_HINT_ANY);
+    }
+    else if ( HEAP_ALGO_TLSF == pCtrl->algo )
+    {
+        pRet = prvTlsfMalloc((TlsfHead_t *)heap, size);
+    }
+    else
+    {
+        pRet = prvFirstFitMalloc((HeapHead_t *)heap, size);
+    }
+    debug_assert(__HEAP_IS_PTR_ALIGNED(pRet));
+    return (pRet);
+}
+
+/*按分配算法分发free, ptr非空, 不记录追踪事件*/
+static void prvFree(HeapDev_t *heap, void *ptr)
+{
+HeapCtrl_t *pCtrl;
+HeapRegionEntry_t *pEntry;
+
+    /*参数检验*/
+    debug_assert(NULL != heap);
+    pCtrl = (HeapCtrl_t *)heap;
+    if ( HEAP_ALGO_REGIONS == pCtrl->algo )
+    {
+        pEntry = prvRegionsFind((HeapRegionsHead_t *)heap, ptr);
+        debug_assert(NULL != pEntry);
+        if ( NULL != pEntry )
+        {
+            prvFree(pEntry->pHeap, ptr);
+        }
+    }
+    else if ( HEAP_ALGO_TLSF == pCtrl->algo )
+    {
+        prvTlsfFree((TlsfHead_t *)heap, ptr);
+    }
+    else
+    {
+        prvFirstFitFree((HeapHead_t *)heap, ptr);
+    }
+}
+
+/*累加Heap空闲块的碎片信息*/
+static void prvGetFragmentation(HeapDev_t *heap, HeapFragInfo_t *info)
+{
+HeapCtrl_t *pCtrl;
+HeapRegionsHead_t *pRegions;
+HeapHead_t *pHeap;
+HeapBlock_t *pBlock;
+size_t i;
+
+    pCtrl = (HeapCtrl_t *)heap;
+    if ( HEAP_ALGO_REGIONS == pCtrl->algo )
+    {
+        pRegions = (HeapRegionsHead_t *)heap;
+        for ( i = 0; i < pRegions->regionCount; i++ )
+        {
+            prvGetFragmentation(pRegions->regions[i].pHeap, info);
+        }
+    }
+    else if ( HEAP_ALGO_TLSF == pCtrl->algo )
+    {
+        prvTlsfGetFragmentation((TlsfHead_t *)heap, info);
+    }
+    else
+    {
+        pHeap = (HeapHead_t *)heap;
+        for (   pBlock = pHeap->startBlock.pNextFreeBlock;
+                pBlock != pHeap->pEndBlock;
+                pBlock = pBlock->pNextFreeBlock
+            )
+        {
+            prvFragAddBlock(info, pBlock->blockSize);
+        }
+    }
+}
+
+/*将一个空闲块计入碎片信息*/
+static void prvFragAddBlock(HeapFragInfo_t *info, size_t blockSize)
+{
+size_t bucket;
+size_t scaled;
+
+    info->freeBlocks++;
+    if ( info->largestFreeBlock < blockSize )
+    {
+        info->largestFreeBlock = blockSize;
+    }
+    for (   bucket = 0, scaled = blockSize >> (HEAP_FRAG_BUCKET_SHIFT+1);
+            (0 != scaled) && (bucket < (HEAP_FRAG_BUCKET_COUNT-1));
+            bucket++, scaled >>= 1
+        )
+    {
+    }
+    info->histogram[bucket]++;
+}
+
+#if HEAP_USE_TRACE
+/*记录一个追踪事件, 缓冲区满后覆盖最旧的事件*/
+static void prvTraceRecord(HeapCtrl_t *pCtrl, void *caller, void *ptr, size_t size)
+{
+HeapTraceEvent_t *pEvent;
+
+    if ( NULL != pCtrl->pTraceBuffer )
+    {
+        pEvent = &pCtrl->pTraceBuffer[pCtrl->traceIndex];
+        pEvent->caller = caller;
+        pEvent->ptr    = ptr;
+        pEvent->size   = size;
+        pCtrl->traceIndex++;
+        if ( pCtrl->traceIndex >= pCtrl->traceSize )
+        {
+            pCtrl->traceIndex = 0;
+        }
+        pCtrl->traceCount++;
+    }
+}
+#endif  /* HEAP_USE_TRACE */
+
+/*******************************************************************************
+
+                                  首次适应算法
+
+*******************************************************************************/
+/*在已对齐的内存上创建首次适应算法Heap*/
+static HeapDev_t *prvFirstFitCreate(uint8_t *pAligned, size_t freeSize)
+{
+HeapHead_t  *pHeap = NULL;
+HeapBlock_t *pBlock;
+
+    if ( freeSize < (HeapHeadStructSize+HeapBlockGuardSize+HeapMinimumBlockSize+HeapBlockStructSize) )
+    {
+        pHeap = NULL;
+    }
+    else
+    {
+        /*分配Heap首部*/
+        pHeap = (HeapHead_t *)pAligned;
+        pAligned += HeapHeadStructSize;
+        freeSize -= HeapHeadStructSize;
+#if HEAP_USE_BOUNDARY_TAG
+        /*首个内存块之前放置已分配标记, 防止向前合并越界*/
+        pAligned += HeapBlockGuardSize;
+        freeSize -= HeapBlockGuardSize;
+        *((size_t *)pAligned - 1) = HeapBlockAllocatedBit;
+#endif
+        /*分配内存块尾结点*/
+        freeSize -= HeapBlockStructSize;
+        pHeap->pEndBlock = (HeapBlock_t *)(pAligned + freeSize);
+        pHeap->pEndBlock->pNextFreeBlock = NULL;
+        pHeap->pEndBlock->blockSize = 0;
+        /*分配空闲内存块*/
+        pBlock = (HeapBlock_t *)pAligned;
+        pBlock->pNextFreeBlock = pHeap->pEndBlock;
+        pBlock->blockSize = freeSize;
+        prvSetBlockTag(pBlock);
+        /*初始化Heap首部*/
+        pHeap->startBlock.pNextFreeBlock = pBlock;
+        pHeap->startBlock.blockSize = 0;
+#if HEAP_USE_BOUNDARY_TAG
+        pBlock->pPrevFreeBlock = &pHeap->startBlock;
+#endif
+        pHeap->ctrl.freeSize  = freeSize;
+        pHeap->ctrl.minimumEverFreeSize = freeSize;
+    }
+    return (pHeap);
+}
+
+/*首次适应算法malloc实现, size已经过合法性检验*/
+static void *prvFirstFitMalloc(HeapHead_t *pHeap, size_t size)
+{
+void *pRet = NULL;
+HeapBlock_t *pPrevBlock, *pNewBlock, *pBlock;
+
+    size += HeapBlockStructSize + HeapBlockTagSize;
+    size  = __HEAP_GET_SIZE_ALIGNED(size);
+#if HEAP_USE_BOUNDARY_TAG
+    /*内存块释放后需容纳空闲链表前驱及边界标记*/
+    if ( size < HeapMinimumBlockSize )
+    {
+        size = HeapMinimumBlockSize;
+    }
+#else
+    /*中断安全模式下, 延迟释放链表指针保存在用户内存中*/
+    if ( size < HeapMinimumAllocSize )
+    {
+        size = HeapMinimumAllocSize;
+    }
+#endif
+    if (size > pHeap->ctrl.freeSize)
+    {
+        pRet = NULL;
+    }
+    else
+    {
+        for (   pPrevBlock = &pHeap->startBlock, pBlock = pHeap->startBlock.pNextFreeBlock;
+                (pBlock->blockSize < size) && (pBlock->pNextFreeBlock != NULL);
+                pPrevBlock = pBlock, pBlock = pBlock->pNextFreeBlock
+            )
+        {
+        }
+        if ( pBlock != pHeap->pEndBlock )
+        {
+            pRet = (void *)( ((uint8_t *)pBlock) + HeapBlockStructSize );
+            prvRemoveBlockFromFreeList(pHeap, pPrevBlock, pBlock);
+            /*分割Block*/
+            pNewBlock = NULL;
+            if ( (pBlock->blockSize - size) > HeapMinimumBlockSize )
+            {
+                pNewBlock = (HeapBlock_t *)( ((uint8_t *)pBlock) + size );
+                debug_assert(__HEAP_IS_PTR_ALIGNED(pNewBlock));
+                pNewBlock->blockSize = pBlock->blockSize - size;
+                pNewBlock->pNextFreeBlock = NULL;
+                pBlock->blockSize = size;
+            }
+            /*更新Heap首部*/
+            pHeap->ctrl.freeSize -= pBlock->blockSize;
+            if ( pHeap->ctrl.minimumEverFreeSize > pHeap->ctrl.freeSize )
+            {
+                pHeap->ctrl.minimumEverFreeSize = pHeap->ctrl.freeSize;
+            }
+            /*标记已分配内存块*/
+            pBlock->pNextFreeBlock = NULL;
+            pBlock->blockSize |= HeapBlockAllocatedBit;
+            prvSetBlockTag(pBlock);
+            /*剩余部分放回空闲链表*/
+            if ( NULL != pNewBlock )
+            {
+                prvInsertBlockIntoFreeList(pHeap, pNewBlock);
+            }
+        }
+    }
+    return (pRet);
+}
+
+/*首次适应算法对齐malloc实现, size已经过合法性检验, alignment大于HEAP_BYTE_ALIGNMENT*/
+static void *prvFirstFitMallocAligned(HeapHead_t *pHeap, size_t size, size_t alignment)
+{
+void *pRet = NULL;
+HeapBlock_t *pPrevBlock, *pBlock, *pAlignedBlock, *pNewBlock;
+size_t gap = 0;
+
+    size += HeapBlockStructSize + HeapBlockTagSize;
+    size  = __HEAP_GET_SIZE_ALIGNED(size);
+#if HEAP_USE_BOUNDARY_TAG
+    if ( size < HeapMinimumBlockSize )
+    {
+        size = HeapMinimumBlockSize;
+    }
+#else
+    if ( size < HeapMinimumAllocSize )
+    {
+        size = HeapMinimumAllocSize;
+    }
+#endif
+    if (size > pHeap->ctrl.freeSize)
+    {
+        pRet = NULL;
+    }
+    else
+    {
+        /*
+            搜索可截取对齐内存块的空闲内存块,
+            前部剩余的gap字节为0, 或者足以构成一个最小内存块
+        */
+        for (   pPrevBlock = &pHeap->startBlock, pBlock = pHeap->startBlock.pNextFreeBlock;
+                pBlock != pHeap->pEndBlock;
+                pPrevBlock = pBlock, pBlock = pBlock->pNextFreeBlock
+            )
+        {
+            gap = (size_t)( (0 - ((size_t)pBlock + HeapBlockStructSize)) & (alignment-1) );
+            while ( (0 != gap) && (gap < HeapMinimumBlockSize) )
+            {
+                gap += alignment;
+            }
+            if ( (pBlock->blockSize >= size) && (pBlock->blockSize - size >= gap) )
+            {
+                break;
+            }
+        }
+        if ( pBlock != pHeap->pEndBlock )
+        {
+            prvRemoveBlockFromFreeList(pHeap, pPrevBlock, pBlock);
+            pAlignedBlock = (HeapBlock_t *)( ((uint8_t *)pBlock) + gap );
+            pAlignedBlock->blockSize = pBlock->blockSize - gap;
+            pRet = (void *)( ((uint8_t *)pAlignedBlock) + HeapBlockStructSize );
+            /*分割尾部剩余内存*/
+            pNewBlock = NULL;
+            if ( (pAlignedBlock->blockSize - size) > HeapMinimumBlockSize )
+            {
+                pNewBlock = (HeapBlock_t *)( ((uint8_t *)pAlignedBlock) + size );
+                pNewBlock->blockSize = pAlignedBlock->blockSize - size;
+                pNewBlock->pNextFreeBlock = NULL;
+                pAlignedBlock->blockSize = size;
+            }
+            /*更新Heap首部*/
+            pHeap->ctrl.freeSize -= pAlignedBlock->blockSize;
+            if ( pHeap->ctrl.minimumEverFreeSize > pHeap->ctrl.freeSize )
+            {
+                pHeap->ctrl.minimumEverFreeSize = pHeap->ctrl.freeSize;
+            }
+            /*标记已分配内存块*/
+            pAlignedBlock->pNextFreeBlock = NULL;
+            pAlignedBlock->blockSize |= HeapBlockAllocatedBit;
+            prvSetBlockTag(pAlignedBlock);
+            /*前部及尾部剩余内存放回空闲链表*/
+            if ( 0 != gap )
+            {
+                pBlock->blockSize = gap;
+                pBlock->pNextFreeBlock = NULL;
+                prvInsertBlockIntoFreeList(pHeap, pBlock);
+            }
+            if ( NULL != pNewBlock )
+            {
+                prvInsertBlockIntoFreeList(pHeap, pNewBlock);
+            }
+        }
+    }
+    return (pRet);
+}
+
+/*首次适应算法realloc实现, ptr非空且size已经过合法性检验*/
+static void *prvFirstFitRealloc(HeapHead_t *pHeap, void *ptr, size_t size)
+{
+void *pRet = NULL;
+HeapBlock_t *pBlock, *pNewBlock;
+HeapBlock_t *pSearchPrev, *pSearch, *pAfter;
+size_t wantedSize;
+size_t allocSize;
+size_t prevSize, nextSize;
+
+    /*计算重新分配的内存大小*/
+    wantedSize  = size;
+    wantedSize += HeapBlockStructSize + HeapBlockTagSize;
+    wantedSize  = __HEAP_GET_SIZE_ALIGNED(wantedSize);
+#if HEAP_USE_BOUNDARY_TAG
+    if ( wantedSize < HeapMinimumBlockSize )
+    {
+        wantedSize = HeapMinimumBlockSize;
+    }
+#else
+    if ( wantedSize < HeapMinimumAllocSize )
+    {
+        wantedSize = HeapMinimumAllocSize;
+    }
+#endif
+    /*获取原先已分配的内存大小*/
+    debug_assert(__HEAP_IS_PTR_ALIGNED(ptr));
+    debug_assert((uint8_t *)ptr > (uint8_t *)pHeap);
+    debug_assert((uint8_t *)ptr < (uint8_t *)(pHeap->pEndBlock));
+    pBlock = (HeapBlock_t *)( ((uint8_t *)ptr) - HeapBlockStructSize );
+    debug_assert(pBlock->blockSize & HeapBlockAllocatedBit);
+    debug_assert(pBlock->pNextFreeBlock == NULL);
+    allocSize   = pBlock->blockSize & (~HeapBlockAllocatedBit);
+    debug_assert(allocSize > HeapBlockStructSize);
+
+    if (wantedSize > allocSize)
+    {
+        prevSize = 0;
+        nextSize = 0;
+        pAfter   = (HeapBlock_t *)( ((uint8_t *)pBlock) + allocSize );
+#if HEAP_USE_BOUNDARY_TAG
+        /*通过边界标记直接获取pBlock两侧的空闲内存块*/
+        pSearchPrev = NULL;
+        pSearch     = NULL;
+        if ( (pAfter != pHeap->pEndBlock) && (0 == (pAfter->blockSize & HeapBlockAllocatedBit)) )
+        {
+            nextSize = pAfter->blockSize;
+        }
+        if ( 0 == (prvGetPrevBlockTag(pBlock) & HeapBlockAllocatedBit) )
+        {
+            prevSize = prvGetPrevBlockTag(pBlock);
+            pSearch  = (HeapBlock_t *)( ((uint8_t *)pBlock) - prevSize );
+        }
+#else
+        /*
+            搜索pBlock两侧的空闲内存块,
+            pSearchPrev .. pSearch .. pBlock .. pAfter
+        */
+        for (   pSearchPrev = NULL, pSearch = &pHeap->startBlock;
+                pSearch->pNextFreeBlock < pBlock;
+                pSearchPrev = pSearch, pSearch = pSearch->pNextFreeBlock
+            )
+        {
+        }
+        if ( (pSearch->pNextFreeBlock != pHeap->pEndBlock) && (pSearch->pNextFreeBlock == pAfter) )
+        {
+            nextSize = pAfter->blockSize;
+        }
+        if ( (pSearchPrev != NULL) && (((uint8_t *)pSearch) + pSearch->blockSize == (uint8_t *)pBlock) )
+        {
+            prevSize = pSearch->blockSize;
+        }
+#endif
+
+        if ( allocSize + nextSize >= wantedSize )
+        {
+            /*吸收后一空闲块, 原地扩大*/
+            pRet = ptr;
+            prvRemoveBlockFromFreeList(pHeap, pSearch, pAfter);
+            pHeap->ctrl.freeSize -= nextSize;
+            allocSize += nextSize;
+            pHeap->ctrl.reallocInPlace++;
+        }
+        else if ( allocSize + nextSize + prevSize >= wantedSize )
+        {
+            /*吸收前一空闲块(以及后一空闲块), 数据前移*/
+            prvRemoveBlockFromFreeList(pHeap, pSearchPrev, pSearch);
+            if ( 0 != nextSize )
+            {
+                prvRemoveBlockFromFreeList(pHeap, pSearchPrev, pAfter);
+            }
+            pRet = (void *)( ((uint8_t *)pSearch) + HeapBlockStructSize );
+            memmove(pRet, ptr, allocSize-HeapBlockStructSize-HeapBlockTagSize);
+            pHeap->ctrl.freeSize -= prevSize + nextSize;
+            allocSize += prevSize + nextSize;
+            pBlock  = pSearch;
+            pSearch = pSearchPrev;
+            pHeap->ctrl.reallocMerged++;
+        }
+        else
+        {
+            /*重新分配内存*/
+            pRet = prvFirstFitMalloc(pHeap, size);
+            if (pRet != NULL)
+            {
+                memcpy(pRet,ptr,allocSize-HeapBlockStructSize-HeapBlockTagSize);
+                prvFirstFitFree(pHeap, ptr);
+                pHeap->ctrl.reallocMoved++;
+            }
+        }
+
+        if ( (pRet != NULL) && (pBlock == (HeapBlock_t *)(((uint8_t *)pRet) - HeapBlockStructSize)) )
+        {
+            /*分割合并后的内存块, 剩余部分的后一内存块必然已分配*/
+            pNewBlock = NULL;
+            if ( (allocSize-wantedSize) > HeapMinimumBlockSize )
+            {
+                pNewBlock = (HeapBlock_t *)( ((uint8_t *)pBlock) + wantedSize );
+                debug_assert(__HEAP_IS_PTR_ALIGNED(pNewBlock));
+                pNewBlock->blockSize = allocSize - wantedSize;
+                pHeap->ctrl.freeSize += pNewBlock->blockSize;
+                allocSize = wantedSize;
+            }
+            pBlock->blockSize = allocSize | HeapBlockAllocatedBit;
+            pBlock->pNextFreeBlock = NULL;
+            prvSetBlockTag(pBlock);
+            if ( NULL != pNewBlock )
+            {
+#if HEAP_USE_BOUNDARY_TAG
+                prvInsertBlockIntoFreeList(pHeap, pNewBlock);
+#else
+                /*直接链接在pSearch之后, 无需再次搜索*/
+                pNewBlock->pNextFreeBlock = pSearch->pNextFreeBlock;
+                pSearch->pNextFreeBlock = pNewBlock;
+#endif
+            }
+            if ( pHeap->ctrl.minimumEverFreeSize > pHeap->ctrl.freeSize )
+            {
+                pHeap->ctrl.minimumEverFreeSize = pHeap->ctrl.freeSize;
+            }
+        }
+    }
+    else
+    {
+        /*分割原有内存*/
+        pRet = ptr;
+        if ( (allocSize-wantedSize) > HeapMinimumBlockSize )
+        {
+            pNewBlock = (HeapBlock_t *)( ((uint8_t *)pBlock) + wantedSize );
+            debug_assert(__HEAP_IS_PTR_ALIGNED(pNewBlock));
+            pNewBlock->blockSize = allocSize - wantedSize;
+            pNewBlock->pNextFreeBlock = NULL;
+            pBlock->blockSize = wantedSize | HeapBlockAllocatedBit;
+            pBlock->pNextFreeBlock = NULL;
+            prvSetBlockTag(pBlock);
+            pHeap->ctrl.freeSize += pNewBlock->blockSize;
+            prvInsertBlockIntoFreeList(pHeap, pNewBlock);
+        }
+        pHeap->ctrl.reallocInPlace++;
+    }
+    return (pRet);
+}
+
+/*首次适应算法free实现, ptr非空*/
+static void prvFirstFitFree(HeapHead_t *pHeap, void *ptr)
+{
+HeapBlock_t *pBlock;
+
+    debug_assert((uint8_t *)ptr > (uint8_t *)pHeap);
+    debug_assert((uint8_t *)ptr < (uint8_t *)(pHeap->pEndBlock));
+    pBlock = (HeapBlock_t *)( ((uint8_t *)ptr) - HeapBlockStructSize );
+    debug_assert(pBlock->blockSize & HeapBlockAllocatedBit);
+    debug_assert(pBlock->pNextFreeBlock == NULL);
+    if ( pBlock->blockSize & HeapBlockAllocatedBit )
+    {
+        if ( pBlock->pNextFreeBlock == NULL )
+        {
+            pBlock->blockSize &= ~HeapBlockAllocatedBit;
+            pHeap->ctrl.freeSize += pBlock->blockSize;
+            prvInsertBlockIntoFreeList(pHeap, pBlock);
+        }
+    }
+}
+
+#if HEAP_USE_BOUNDARY_TAG
+/*获取物理相邻的前一内存块的边界标记*/
+STATIC_INLINE size_t prvGetPrevBlockTag(HeapBlock_t *pBlock)
+{
+    return ( *((size_t *)pBlock - 1) );
+}
+
+/*将内存块大小及分配标志写入内存块尾部的边界标记*/
+STATIC_INLINE void prvSetBlockTag(HeapBlock_t *pBlock)
+{
+size_t blockSize = pBlock->blockSize & (~HeapBlockAllocatedBit);
+
+    *((size_t *)( ((uint8_t *)pBlock) + blockSize ) - 1) = pBlock->blockSize;
+}
+
+/*将内存块从双向空闲链表中移除, pPrevBlock未使用*/
+static void prvRemoveBlockFromFreeList(HeapHead_t *pHeap, HeapBlock_t *pPrevBlock, HeapBlock_t *pBlock)
+{
+    (void)pPrevBlock;
+    pBlock->pPrevFreeBlock->pNextFreeBlock = pBlock->pNextFreeBlock;
+    if ( pBlock->pNextFreeBlock != pHeap->pEndBlock )
+    {
+        pBlock->pNextFreeBlock->pPrevFreeBlock = pBlock->pPrevFreeBlock;
+    }
+}
+
+/*
+ * 将孤立的内存块插入到空闲内存块链表头部, 并通过边界标记完成相邻内存块合并,
+ * 空闲链表不再按地址排序
+ */
+static void prvInsertBlockIntoFreeList(HeapHead_t *pHeap, HeapBlock_t *pBlockToInsert)
+{
+HeapBlock_t *pNeighbour;
+size_t prevTag;
+
+    /*尝试合并pBlockToInsert .. 后一内存块*/
+    pNeighbour = (HeapBlock_t *)( ((uint8_t *)pBlockToInsert) + pBlockToInsert->blockSize );
+    if ( (pNeighbour != pHeap->pEndBlock) && (0 == (pNeighbour->blockSize & HeapBlockAllocatedBit)) )
+    {
+        prvRemoveBlockFromFreeList(pHeap, NULL, pNeighbour);
+        pBlockToInsert->blockSize += pNeighbour->blockSize;
+    }
+
+    /*尝试合并前一内存块 .. pBlockToInsert*/
+    prevTag = prvGetPrevBlockTag(pBlockToInsert);
+    if ( 0 == (prevTag & HeapBlockAllocatedBit) )
+    {
+        pNeighbour = (HeapBlock_t *)( ((uint8_t *)pBlockToInsert) - prevTag );
+        prvRemoveBlockFromFreeList(pHeap, NULL, pNeighbour);
+        pNeighbour->blockSize += pBlockToInsert->blockSize;
+        pBlockToInsert = pNeighbour;
+    }
+
+    /*插入空闲链表头部*/
+    prvSetBlockTag(pBlockToInsert);
+    pBlockToInsert->pNextFreeBlock = pHeap->startBlock.pNextFreeBlock;
+    pBlockToInsert->pPrevFreeBlock = &pHeap->startBlock;
+    if ( pBlockToInsert->pNextFreeBlock != pHeap->pEndBlock )
+    {
+        pBlockToInsert->pNextFreeBlock->pPrevFreeBlock = pBlockToInsert;
+    }
+    pHeap->startBlock.pNextFreeBlock = pBlockToInsert;
+}
+
+#else   /* HEAP_USE_BOUNDARY_TAG */
+/*未使用边界标记时无动作*/
+STATIC_INLINE void prvSetBlockTag(HeapBlock_t *pBlock)
+{
+    (void)pBlock;
+}
+
+/*将内存块从地址有序的空闲链表中移除, pPrevBlock为其在链表中的前驱*/
+static void prvRemoveBlockFromFreeList(HeapHead_t *pHeap, HeapBlock_t *pPrevBlock, HeapBlock_t *pBlock)
+{
+    (void)pHeap;
+    debug_assert(pPrevBlock->pNextFreeBlock == pBlock);
+    pPrevBlock->pNextFreeBlock = pBlock->pNextFreeBlock;
+}
+
+/*将孤立的内存块重新插入到空闲内存块链表, 并完成相邻内存块合并*/
+static void prvInsertBlockIntoFreeList(HeapHead_t *pHeap, HeapBlock_t *pBlockToInsert)
+{
+HeapBlock_t *pSearch;
+uint8_t *puc;
 
     /*
         搜索pBlockToInsert插入位置,
@@ -443,3 +1667,603 @@ uint8_t *puc;
         pSearch->pNextFreeBlock = pBlockToInsert;
     }
 }
+#endif  /* HEAP_USE_BOUNDARY_TAG */
+
+/*******************************************************************************
+
+                                 TLSF分配算法
+
+*******************************************************************************/
+/*获取最高有效位的位置, word不能为0*/
+static ubase_t prvTlsfFls(uint32_t word)
+{
+#ifdef CPU_CLZ
+    return (ubase_t)( 31 - CPU_CLZ(word) );
+#else
+ubase_t bit = 0;
+
+    if ( word & 0xFFFF0000UL ) { word >>= 16; bit += 16; }
+    if ( word & 0x0000FF00UL ) { word >>= 8;  bit += 8;  }
+    if ( word & 0x000000F0UL ) { word >>= 4;  bit += 4;  }
+    if ( word & 0x0000000CUL ) { word >>= 2;  bit += 2;  }
+    if ( word & 0x00000002UL ) {              bit += 1;  }
+    return (bit);
+#endif
+}
+
+/*获取最低有效位的位置, word不能为0*/
+static ubase_t prvTlsfFfs(uint32_t word)
+{
+    return prvTlsfFls( word & (~word + 1) );
+}
+
+/*计算内存块大小对应的一级/二级索引*/
+static void prvTlsfMappingInsert(size_t size, ubase_t *pFl, ubase_t *pSl)
+{
+ubase_t fl;
+
+    if ( size < __TLSF_SMALL_BLOCK_SIZE )
+    {
+        *pFl = 0;
+        *pSl = (ubase_t)( size >> __TLSF_ALIGN_SIZE_LOG2 );
+    }
+    else
+    {
+        fl   = prvTlsfFls((uint32_t)size);
+        *pSl = (ubase_t)( (size >> (fl - HEAP_TLSF_SL_INDEX_COUNT_LOG2)) ^ __TLSF_SL_INDEX_COUNT );
+        *pFl = (ubase_t)( fl - __TLSF_FL_INDEX_SHIFT + 1 );
+    }
+}
+
+/*计算分配时的查找索引, 向上取整到下一个二级区间, 保证区间内任一内存块都满足要求*/
+static void prvTlsfMappingSearch(size_t size, ubase_t *pFl, ubase_t *pSl)
+{
+    if ( size >= __TLSF_SMALL_BLOCK_SIZE )
+    {
+        size += ( ((size_t)1) << (prvTlsfFls((uint32_t)size) - HEAP_TLSF_SL_INDEX_COUNT_LOG2) ) - 1;
+    }
+    prvTlsfMappingInsert(size, pFl, pSl);
+}
+
+/*获取TLSF内存块大小*/
+STATIC_INLINE size_t prvTlsfBlockSize(const TlsfBlock_t *pBlock)
+{
+    return ( pBlock->blockSize & (~HeapBlockAllocatedBit) );
+}
+
+/*获取物理相邻的后一内存块*/
+STATIC_INLINE TlsfBlock_t *prvTlsfNextPhysBlock(const TlsfBlock_t *pBlock)
+{
+    return (TlsfBlock_t *)( ((uint8_t *)pBlock) + prvTlsfBlockSize(pBlock) );
+}
+
+/*将空闲内存块插入对应的空闲链表头部*/
+static void prvTlsfInsertFreeBlock(TlsfHead_t *pTlsf, TlsfBlock_t *pBlock)
+{
+ubase_t fl, sl;
+TlsfBlock_t *pHead;
+
+    prvTlsfMappingInsert(pBlock->blockSize, &fl, &sl);
+    pHead = pTlsf->pFreeLists[fl][sl];
+    pBlock->pNextFreeBlock = pHead;
+    pBlock->pPrevFreeBlock = NULL;
+    if ( NULL != pHead )
+    {
+        pHead->pPrevFreeBlock = pBlock;
+    }
+    pTlsf->pFreeLists[fl][sl] = pBlock;
+    pTlsf->flBitmap    |= ((uint32_t)1) << fl;
+    pTlsf->slBitmap[fl] |= (uint16_t)( 1U << sl );
+}
+
+/*将空闲内存块从对应的空闲链表中移除*/
+static void prvTlsfRemoveFreeBlock(TlsfHead_t *pTlsf, TlsfBlock_t *pBlock)
+{
+ubase_t fl, sl;
+TlsfBlock_t *pNext = pBlock->pNextFreeBlock;
+TlsfBlock_t *pPrev = pBlock->pPrevFreeBlock;
+
+    prvTlsfMappingInsert(pBlock->blockSize, &fl, &sl);
+    if ( NULL != pNext )
+    {
+        pNext->pPrevFreeBlock = pPrev;
+    }
+    if ( NULL != pPrev )
+    {
+        pPrev->pNextFreeBlock = pNext;
+    }
+    else
+    {
+        debug_assert(pTlsf->pFreeLists[fl][sl] == pBlock);
+        pTlsf->pFreeLists[fl][sl] = pNext;
+        if ( NULL == pNext )
+        {
+            pTlsf->slBitmap[fl] &= (uint16_t)~( 1U << sl );
+            if ( 0 == pTlsf->slBitmap[fl] )
+            {
+                pTlsf->flBitmap &= ~( ((uint32_t)1) << fl );
+            }
+        }
+    }
+}
+
+/*查找不小于索引(fl,sl)的第一个非空空闲链表, 返回其头部内存块*/
+static TlsfBlock_t *prvTlsfFindSuitableBlock(TlsfHead_t *pTlsf, ubase_t fl, ubase_t sl)
+{
+uint32_t flMap;
+uint16_t slMap;
+
+    slMap = pTlsf->slBitmap[fl] & (uint16_t)( 0xFFFFU << sl );
+    if ( 0 == slMap )
+    {
+        /*fl已是最高一级索引时没有更大的一级链表, 避免移位数达到32*/
+        flMap = 0;
+        if ( fl + 1 < __TLSF_FL_INDEX_COUNT )
+        {
+            flMap = pTlsf->flBitmap & ( 0xFFFFFFFFUL << (fl + 1) );
+        }
+        if ( 0 == flMap )
+        {
+            return (NULL);
+        }
+        fl    = prvTlsfFfs(flMap);
+        slMap = pTlsf->slBitmap[fl];
+        debug_assert(0 != slMap);
+    }
+    sl = prvTlsfFfs(slMap);
+    return (pTlsf->pFreeLists[fl][sl]);
+}
+
+/*
+ * 从已分配内存块尾部分割出多余部分, 分割出的内存块保持已分配状态
+ * 返回分割出的内存块, 若剩余部分不足最小内存块返回NULL
+ */
+static TlsfBlock_t *prvTlsfSplitBlock(TlsfBlock_t *pBlock, size_t size)
+{
+TlsfBlock_t *pRemain = NULL;
+size_t blockSize = prvTlsfBlockSize(pBlock);
+
+    if ( (blockSize - size) >= TlsfMinimumBlockSize )
+    {
+        pRemain = (TlsfBlock_t *)( ((uint8_t *)pBlock) + size );
+        debug_assert(__HEAP_IS_PTR_ALIGNED(pRemain));
+        pRemain->blockSize = (blockSize - size) | HeapBlockAllocatedBit;
+        pRemain->pPrevPhysBlock = pBlock;
+        prvTlsfNextPhysBlock(pRemain)->pPrevPhysBlock = pRemain;
+        pBlock->blockSize = size | (pBlock->blockSize & HeapBlockAllocatedBit);
+    }
+    return (pRemain);
+}
+
+/*释放已分配的内存块, 与物理相邻的空闲块合并后插入空闲链表*/
+static void prvTlsfReleaseBlock(TlsfHead_t *pTlsf, TlsfBlock_t *pBlock)
+{
+TlsfBlock_t *pPrev, *pNext;
+
+    debug_assert(pBlock->blockSize & HeapBlockAllocatedBit);
+    pBlock->blockSize &= ~HeapBlockAllocatedBit;
+    /*合并前一内存块*/
+    pPrev = pBlock->pPrevPhysBlock;
+    if ( (NULL != pPrev) && (0 == (pPrev->blockSize & HeapBlockAllocatedBit)) )
+    {
+        prvTlsfRemoveFreeBlock(pTlsf, pPrev);
+        pPrev->blockSize += pBlock->blockSize;
+        pBlock = pPrev;
+    }
+    /*合并后一内存块, 尾结点标记为已分配, 不会被合并*/
+    pNext = prvTlsfNextPhysBlock(pBlock);
+    if ( 0 == (pNext->blockSize & HeapBlockAllocatedBit) )
+    {
+        prvTlsfRemoveFreeBlock(pTlsf, pNext);
+        pBlock->blockSize += pNext->blockSize;
+    }
+    prvTlsfNextPhysBlock(pBlock)->pPrevPhysBlock = pBlock;
+    prvTlsfInsertFreeBlock(pTlsf, pBlock);
+}
+
+/*在已对齐的内存上创建TLSF算法Heap*/
+static HeapDev_t *prvTlsfCreate(uint8_t *pAligned, size_t freeSize)
+{
+TlsfHead_t  *pTlsf = NULL;
+TlsfBlock_t *pBlock;
+size_t       blockSize;
+
+    if ( freeSize < (TlsfHeadStructSize+TlsfMinimumBlockSize+TlsfBlockHeadSize) )
+    {
+        pTlsf = NULL;
+    }
+    else
+    {
+        /*分配TLSF首部*/
+        pTlsf = (TlsfHead_t *)pAligned;
+        memset(pTlsf, 0, sizeof(TlsfHead_t));
+        pAligned += TlsfHeadStructSize;
+        blockSize = freeSize - TlsfHeadStructSize - TlsfBlockHeadSize;
+        /*超出TLSF索引范围的内存不予管理*/
+        if ( blockSize >= (TlsfMaximumAllocSize << 1) )
+        {
+            blockSize = (TlsfMaximumAllocSize << 1) - HEAP_BYTE_ALIGNMENT;
+        }
+        /*分配空闲内存块与内存块尾结点*/
+        pBlock = (TlsfBlock_t *)pAligned;
+        pBlock->pPrevPhysBlock = NULL;
+        pBlock->blockSize = blockSize;
+        pTlsf->pStartBlock = pBlock;
+        pTlsf->pEndBlock = (TlsfBlock_t *)(pAligned + blockSize);
+        pTlsf->pEndBlock->pPrevPhysBlock = pBlock;
+        pTlsf->pEndBlock->blockSize = 0 | HeapBlockAllocatedBit;
+        prvTlsfInsertFreeBlock(pTlsf, pBlock);
+        /*初始化Heap首部*/
+        pTlsf->ctrl.freeSize = blockSize;
+        pTlsf->ctrl.minimumEverFreeSize = blockSize;
+    }
+    return (pTlsf);
+}
+
+/*TLSF算法malloc实现, size已经过合法性检验*/
+static void *prvTlsfMalloc(TlsfHead_t *pTlsf, size_t size)
+{
+void *pRet = NULL;
+ubase_t fl, sl;
+TlsfBlock_t *pBlock, *pRemain;
+
+    size += TlsfBlockHeadSize;
+    size  = __HEAP_GET_SIZE_ALIGNED(size);
+    if ( size < TlsfMinimumBlockSize )
+    {
+        size = TlsfMinimumBlockSize;
+    }
+    if ( (size > pTlsf->ctrl.freeSize) || (size > TlsfMaximumAllocSize) )
+    {
+        pRet = NULL;
+    }
+    else
+    {
+        prvTlsfMappingSearch(size, &fl, &sl);
+        pBlock = prvTlsfFindSuitableBlock(pTlsf, fl, sl);
+        if ( NULL != pBlock )
+        {
+            debug_assert(prvTlsfBlockSize(pBlock) >= size);
+            prvTlsfRemoveFreeBlock(pTlsf, pBlock);
+            pBlock->blockSize |= HeapBlockAllocatedBit;
+            /*分割Block*/
+            pRemain = prvTlsfSplitBlock(pBlock, size);
+            if ( NULL != pRemain )
+            {
+                pRemain->blockSize &= ~HeapBlockAllocatedBit;
+                prvTlsfInsertFreeBlock(pTlsf, pRemain);
+            }
+            /*更新Heap首部*/
+            pTlsf->ctrl.freeSize -= prvTlsfBlockSize(pBlock);
+            if ( pTlsf->ctrl.minimumEverFreeSize > pTlsf->ctrl.freeSize )
+            {
+                pTlsf->ctrl.minimumEverFreeSize = pTlsf->ctrl.freeSize;
+            }
+            pRet = (void *)( ((uint8_t *)pBlock) + TlsfBlockHeadSize );
+        }
+    }
+    return (pRet);
+}
+
+/*TLSF算法对齐malloc实现, size已经过合法性检验, alignment大于HEAP_BYTE_ALIGNMENT*/
+static void *prvTlsfMallocAligned(TlsfHead_t *pTlsf, size_t size, size_t alignment)
+{
+void *pRet = NULL;
+ubase_t fl, sl;
+TlsfBlock_t *pBlock, *pAlignedBlock, *pRemain;
+size_t searchSize;
+size_t gap;
+
+    size += TlsfBlockHeadSize;
+    size  = __HEAP_GET_SIZE_ALIGNED(size);
+    if ( size < TlsfMinimumBlockSize )
+    {
+        size = TlsfMinimumBlockSize;
+    }
+    /*查找的内存块需容纳最坏情况下的前部剩余内存*/
+    searchSize = size + alignment + TlsfMinimumBlockSize;
+    if (    ( searchSize < size ) ||
+            ( searchSize > pTlsf->ctrl.freeSize ) ||
+            ( searchSize > TlsfMaximumAllocSize )
+        )
+    {
+        pRet = NULL;
+    }
+    else
+    {
+        prvTlsfMappingSearch(searchSize, &fl, &sl);
+        pBlock = prvTlsfFindSuitableBlock(pTlsf, fl, sl);
+        if ( NULL != pBlock )
+        {
+            prvTlsfRemoveFreeBlock(pTlsf, pBlock);
+            pBlock->blockSize |= HeapBlockAllocatedBit;
+            /*截取前部剩余内存, 其前一内存块必然已分配, 直接放回空闲链表*/
+            gap = (size_t)( (0 - ((size_t)pBlock + TlsfBlockHeadSize)) & (alignment-1) );
+            while ( (0 != gap) && (gap < TlsfMinimumBlockSize) )
+            {
+                gap += alignment;
+            }
+            pAlignedBlock = pBlock;
+            if ( 0 != gap )
+            {
+                pAlignedBlock = prvTlsfSplitBlock(pBlock, gap);
+                debug_assert(NULL != pAlignedBlock);
+                pBlock->blockSize &= ~HeapBlockAllocatedBit;
+                prvTlsfInsertFreeBlock(pTlsf, pBlock);
+            }
+            /*分割尾部剩余内存*/
+            pRemain = prvTlsfSplitBlock(pAlignedBlock, size);
+            if ( NULL != pRemain )
+            {
+                pRemain->blockSize &= ~HeapBlockAllocatedBit;
+                prvTlsfInsertFreeBlock(pTlsf, pRemain);
+            }
+            /*更新Heap首部*/
+            pTlsf->ctrl.freeSize -= prvTlsfBlockSize(pAlignedBlock);
+            if ( pTlsf->ctrl.minimumEverFreeSize > pTlsf->ctrl.freeSize )
+            {
+                pTlsf->ctrl.minimumEverFreeSize = pTlsf->ctrl.freeSize;
+            }
+            pRet = (void *)( ((uint8_t *)pAlignedBlock) + TlsfBlockHeadSize );
+        }
+    }
+    return (pRet);
+}
+
+/*TLSF算法realloc实现, ptr非空且size已经过合法性检验*/
+static void *prvTlsfRealloc(TlsfHead_t *pTlsf, void *ptr, size_t size)
+{
+void *pRet = NULL;
+TlsfBlock_t *pBlock, *pRemain, *pPrev, *pNext;
+size_t wantedSize;
+size_t allocSize;
+size_t prevSize, nextSize;
+
+    /*计算重新分配的内存大小*/
+    wantedSize = __HEAP_GET_SIZE_ALIGNED(size + TlsfBlockHeadSize);
+    if ( wantedSize < TlsfMinimumBlockSize )
+    {
+        wantedSize = TlsfMinimumBlockSize;
+    }
+    /*获取原先已分配的内存大小*/
+    debug_assert(__HEAP_IS_PTR_ALIGNED(ptr));
+    debug_assert((uint8_t *)ptr > (uint8_t *)(pTlsf->pStartBlock));
+    debug_assert((uint8_t *)ptr < (uint8_t *)(pTlsf->pEndBlock));
+    pBlock = (TlsfBlock_t *)( ((uint8_t *)ptr) - TlsfBlockHeadSize );
+    debug_assert(pBlock->blockSize & HeapBlockAllocatedBit);
+    allocSize = prvTlsfBlockSize(pBlock);
+
+    if (wantedSize > allocSize)
+    {
+        /*获取物理相邻的空闲内存块*/
+        pPrev = pBlock->pPrevPhysBlock;
+        pNext = prvTlsfNextPhysBlock(pBlock);
+        prevSize = 0;
+        nextSize = 0;
+        if ( 0 == (pNext->blockSize & HeapBlockAllocatedBit) )
+        {
+            nextSize = pNext->blockSize;
+        }
+        if ( (NULL != pPrev) && (0 == (pPrev->blockSize & HeapBlockAllocatedBit)) )
+        {
+            prevSize = pPrev->blockSize;
+        }
+
+        if ( allocSize + nextSize >= wantedSize )
+        {
+            /*吸收后一空闲块, 原地扩大*/
+            pRet = ptr;
+            prvTlsfRemoveFreeBlock(pTlsf, pNext);
+            pBlock->blockSize += nextSize;
+            prevSize = 0;
+            pTlsf->ctrl.reallocInPlace++;
+        }
+        else if ( allocSize + nextSize + prevSize >= wantedSize )
+        {
+            /*吸收前一空闲块(以及后一空闲块), 数据前移*/
+            prvTlsfRemoveFreeBlock(pTlsf, pPrev);
+            if ( 0 != nextSize )
+            {
+                prvTlsfRemoveFreeBlock(pTlsf, pNext);
+            }
+            pRet = (void *)( ((uint8_t *)pPrev) + TlsfBlockHeadSize );
+            memmove(pRet, ptr, allocSize-TlsfBlockHeadSize);
+            pPrev->blockSize = (prevSize + allocSize + nextSize) | HeapBlockAllocatedBit;
+            pBlock = pPrev;
+            pTlsf->ctrl.reallocMerged++;
+        }
+        else
+        {
+            /*重新分配内存*/
+            pRet = prvTlsfMalloc(pTlsf, size);
+            if (pRet != NULL)
+            {
+                memcpy(pRet, ptr, allocSize-TlsfBlockHeadSize);
+                prvTlsfFree(pTlsf, ptr);
+                pTlsf->ctrl.reallocMoved++;
+            }
+        }
+
+        if ( (pRet != NULL) && (pBlock == (TlsfBlock_t *)(((uint8_t *)pRet) - TlsfBlockHeadSize)) )
+        {
+            /*分割合并后的内存块, 多余部分放回空闲链表, 其后一内存块必然已分配*/
+            prvTlsfNextPhysBlock(pBlock)->pPrevPhysBlock = pBlock;
+            pTlsf->ctrl.freeSize -= prevSize + nextSize;
+            pRemain = prvTlsfSplitBlock(pBlock, wantedSize);
+            if ( NULL != pRemain )
+            {
+                pRemain->blockSize &= ~HeapBlockAllocatedBit;
+                pTlsf->ctrl.freeSize += pRemain->blockSize;
+                prvTlsfInsertFreeBlock(pTlsf, pRemain);
+            }
+            if ( pTlsf->ctrl.minimumEverFreeSize > pTlsf->ctrl.freeSize )
+            {
+                pTlsf->ctrl.minimumEverFreeSize = pTlsf->ctrl.freeSize;
+            }
+        }
+    }
+    else
+    {
+        /*分割原有内存, 多余部分与后一空闲块合并*/
+        pRet = ptr;
+        pRemain = prvTlsfSplitBlock(pBlock, wantedSize);
+        if ( NULL != pRemain )
+        {
+            pTlsf->ctrl.freeSize += prvTlsfBlockSize(pRemain);
+            prvTlsfReleaseBlock(pTlsf, pRemain);
+        }
+        pTlsf->ctrl.reallocInPlace++;
+    }
+    return (pRet);
+}
+
+/*TLSF算法free实现, ptr非空*/
+static void prvTlsfFree(TlsfHead_t *pTlsf, void *ptr)
+{
+TlsfBlock_t *pBlock;
+
+    debug_assert((uint8_t *)ptr > (uint8_t *)(pTlsf->pStartBlock));
+    debug_assert((uint8_t *)ptr < (uint8_t *)(pTlsf->pEndBlock));
+    pBlock = (TlsfBlock_t *)( ((uint8_t *)ptr) - TlsfBlockHeadSize );
+    debug_assert(pBlock->blockSize & HeapBlockAllocatedBit);
+    if ( pBlock->blockSize & HeapBlockAllocatedBit )
+    {
+        pTlsf->ctrl.freeSize += prvTlsfBlockSize(pBlock);
+        prvTlsfReleaseBlock(pTlsf, pBlock);
+    }
+}
+
+/*统计TLSF空闲内存块数量, 按物理顺序遍历全部内存块*/
+static size_t prvTlsfCountFreeBlocks(TlsfHead_t *pTlsf)
+{
+size_t count = 0;
+TlsfBlock_t *pBlock;
+
+    for (   pBlock = pTlsf->pStartBlock;
+            pBlock != pTlsf->pEndBlock;
+            pBlock = prvTlsfNextPhysBlock(pBlock)
+        )
+    {
+        if ( 0 == (pBlock->blockSize & HeapBlockAllocatedBit) )
+        {
+            count++;
+        }
+    }
+    return (count);
+}
+
+/*TLSF算法碎片统计, 遍历全部物理内存块*/
+static void prvTlsfGetFragmentation(TlsfHead_t *pTlsf, HeapFragInfo_t *info)
+{
+TlsfBlock_t *pBlock;
+
+    for (   pBlock = pTlsf->pStartBlock;
+            pBlock != pTlsf->pEndBlock;
+            pBlock = prvTlsfNextPhysBlock(pBlock)
+        )
+    {
+        if ( 0 == (pBlock->blockSize & HeapBlockAllocatedBit) )
+        {
+            prvFragAddBlock(info, pBlock->blockSize);
+        }
+    }
+}
+
+/*******************************************************************************
+
+                                   多区域Heap
+
+*******************************************************************************/
+/*获取已分配内存的可用大小*/
+static size_t prvGetUsableSize(HeapCtrl_t *pCtrl, void *ptr)
+{
+size_t size;
+
+    if ( HEAP_ALGO_TLSF == pCtrl->algo )
+    {
+        size = prvTlsfBlockSize((TlsfBlock_t *)( ((uint8_t *)ptr) - TlsfBlockHeadSize ));
+        size -= TlsfBlockHeadSize;
+    }
+    else
+    {
+        size = ((HeapBlock_t *)( ((uint8_t *)ptr) - HeapBlockStructSize ))->blockSize;
+        size = (size & (~HeapBlockAllocatedBit)) - HeapBlockStructSize - HeapBlockTagSize;
+    }
+    return (size);
+}
+
+/*查找内存地址所属的区域*/
+static HeapRegionEntry_t *prvRegionsFind(HeapRegionsHead_t *pRegions, void *ptr)
+{
+HeapRegionEntry_t *pEntry = NULL;
+size_t i;
+
+    for ( i = 0; i < pRegions->regionCount; i++ )
+    {
+        if (    ( (uint8_t *)ptr >= pRegions->regions[i].pStart ) &&
+                ( (uint8_t *)ptr <  pRegions->regions[i].pEnd )
+            )
+        {
+            pEntry = &pRegions->regions[i];
+            break;
+        }
+    }
+    return (pEntry);
+}
+
+/*按位置提示在各区域中分配内存, size已经过合法性检验*/
+static void *prvRegionsMalloc(HeapRegionsHead_t *pRegions, size_t size, uint8_t hint)
+{
+void *pRet = NULL;
+uint8_t attr = hint & (uint8_t)(~HEAP_HINT_STRICT);
+size_t i;
+
+    /*优先在具有全部指定属性的区域中分配*/
+    for ( i = 0; (i < pRegions->regionCount) && (NULL == pRet); i++ )
+    {
+        if ( attr == (pRegions->regions[i].attr & attr) )
+        {
+            pRet = heap_Malloc(pRegions->regions[i].pHeap, size);
+        }
+    }
+    /*其次在其余区域中分配*/
+    if ( 0 == (hint & HEAP_HINT_STRICT) )
+    {
+        for ( i = 0; (i < pRegions->regionCount) && (NULL == pRet); i++ )
+        {
+            if ( attr != (pRegions->regions[i].attr & attr) )
+            {
+                pRet = heap_Malloc(pRegions->regions[i].pHeap, size);
+            }
+        }
+    }
+    return (pRet);
+}
+
+/*多区域Heap的realloc实现, 优先在原区域内完成, ptr非空且size已经过合法性检验*/
+static void *prvRegionsRealloc(HeapRegionsHead_t *pRegions, void *ptr, size_t size)
+{
+void *pRet = NULL;
+HeapRegionEntry_t *pEntry;
+size_t usableSize;
+
+    pEntry = prvRegionsFind(pRegions, ptr);
+    debug_assert(NULL != pEntry);
+    if ( NULL != pEntry )
+    {
+        usableSize = prvGetUsableSize((HeapCtrl_t *)pEntry->pHeap, ptr);
+        pRet = heap_Realloc(pEntry->pHeap, ptr, size);
+        if ( NULL == pRet )
+        {
+            /*原区域空间不足, 优先迁移到属性相同的区域*/
+            pRet = prvRegionsMalloc(pRegions, size, pEntry->attr);
+            if ( NULL != pRet )
+            {
+                memcpy(pRet, ptr, (usableSize < size) ? usableSize : size);
+                heap_Free(pEntry->pHeap, ptr);
+                pRegions->ctrl.reallocMoved++;
+            }
+        }
+    }
+    return (pRet);
+}
@@ -0,0 +1,258 @@
+/*******************************************************************************
+* 文 件 名: cpulib_msgq.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 变长消息队列, 建立在SPSC FIFO之上
+*******************************************************************************/
+
+#include "cpulib_msgq.h"
+#include <string.h>
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+/*消息长度前缀大小*/
+#define __MSGQ_HEAD_SIZE                ( sizeof(size_t) )
+
+/*填充记录标志, 读索引遇到后直接跳至存储区起始位置*/
+#define __MSGQ_PAD                      ( ~((size_t)0) )
+
+/*
+ * 获取消息记录占用的存储区大小(长度前缀加消息内容, 按长度前缀大小对齐)
+ * len:    消息长度
+ * return: 记录大小
+ */
+#define __MSGQ_RECORD_SIZE(len)         \
+    ( __MSGQ_HEAD_SIZE + (((size_t)(len) + __MSGQ_HEAD_SIZE - 1) & ~(__MSGQ_HEAD_SIZE - 1)) )
+
+/*
+ * 获取存储区指定偏移处的长度前缀指针
+ * pFIFO:  SPSC FIFO指针
+ * off:    存储区偏移
+ * return: 长度前缀指针
+ */
+#define __MSGQ_HEAD_AT(pFIFO, off)      \
+    ( (size_t *)((uint8_t *)((pFIFO)->data) + (off)) )
+
+/*******************************************************************************
+
+                                 生产者操作函数
+
+*******************************************************************************/
+/**
+ * 在消息队列中预留一条消息的存储区, 生产者直接写入后调用msgq_Commit()
+ *
+ * @param pmsgq: 消息队列指针
+ *
+ * @param len: 消息长度, 不能为0, 消息记录大小不能超过存储区的一半
+ *
+ * @note: 末尾连续空间不足时, 在此写入填充记录, 消息存储区位于存储区起始位置;
+ *        在msgq_Commit()之前, 消费者看不到该消息;
+ *        记录大小不超过存储区一半时, 消息队列排空后无论写索引位于何处都能容纳,
+ *        超过时依位置可能永远无法写入, 因此直接拒绝
+ *
+ * @return: 若空间足够, 返回按sizeof(size_t)对齐的消息存储区地址,
+ *          若空间不足, 返回NULL, 消息队列保持不变
+ */
+void *msgq_Reserve( MsgQueue_t *pmsgq, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pmsgq;
+size_t size  = pFIFO->mask + 1;
+size_t in    = pFIFO->in;
+size_t avail = size - (in - pFIFO->out);
+size_t off   = in & pFIFO->mask;
+size_t tail  = size - off;
+size_t need  = __MSGQ_RECORD_SIZE(len);
+
+    debug_assert(1 == pFIFO->esize);
+    /*读索引先于存储内容写入*/
+    CPU_DMB();
+    if ( (0 == len) || (len > MSGQ_MAX_LEN(size)) )
+    {
+        return (NULL);
+    }
+    if ( tail >= need )
+    {
+        if ( avail < need )
+        {
+            return (NULL);
+        }
+    }
+    else
+    {
+        if ( avail < tail + need )
+        {
+            return (NULL);
+        }
+        *__MSGQ_HEAD_AT(pFIFO, off) = __MSGQ_PAD;
+        off = 0;
+    }
+    return ( (uint8_t *)__MSGQ_HEAD_AT(pFIFO, off) + __MSGQ_HEAD_SIZE );
+}
+
+/**
+ * 提交由msgq_Reserve()预留的消息, 消息整体对消费者可见
+ *
+ * @param pmsgq: 消息队列指针
+ *
+ * @param len: 消息长度, 须与msgq_Reserve()的参数相同
+ */
+void msgq_Commit( MsgQueue_t *pmsgq, size_t len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pmsgq;
+size_t size = pFIFO->mask + 1;
+size_t in   = pFIFO->in;
+size_t off  = in & pFIFO->mask;
+size_t tail = size - off;
+size_t need = __MSGQ_RECORD_SIZE(len);
+
+    /*填充记录已由msgq_Reserve()写入*/
+    if ( tail < need )
+    {
+        in += tail;
+        off = 0;
+    }
+    *__MSGQ_HEAD_AT(pFIFO, off) = len;
+    debug_assert(in + need - pFIFO->out <= size);
+    /*存储内容先于写索引更新*/
+    CPU_DMB();
+    pFIFO->in = in + need;
+}
+
+/**
+ * 发送一条消息, 全部写入或不写入
+ *
+ * @param pmsgq: 消息队列指针
+ *
+ * @param msg: 消息内容地址
+ *
+ * @param len: 消息长度, 不能为0, 不能超过MSGQ_MAX_LEN(size)
+ *
+ * @return: 返回布尔值, true表示发送成功, false表示空间不足或消息过长
+ */
+bool msgq_Send( MsgQueue_t *pmsgq, const void *msg, size_t len )
+{
+void *pBuf;
+
+    pBuf = msgq_Reserve(pmsgq, len);
+    if ( NULL == pBuf )
+    {
+        return (false);
+    }
+    memcpy(pBuf, msg, len);
+    msgq_Commit(pmsgq, len);
+    return (true);
+}
+
+/*******************************************************************************
+
+                                 消费者操作函数
+
+*******************************************************************************/
+/**
+ * 获取下一条消息, 不复制内容, 也不出队列
+ *
+ * @param pmsgq: 消息队列指针
+ *
+ * @param len: 返回消息长度
+ *
+ * @return: 若消息队列非空, 返回消息内容地址, 在msgq_Consume()之前保持有效,
+ *          若消息队列为空, 返回NULL
+ */
+void *msgq_Peek( MsgQueue_t *pmsgq, size_t *len )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pmsgq;
+size_t out = pFIFO->out;
+size_t off;
+size_t *pHead;
+
+    for ( ;; )
+    {
+        if ( pFIFO->in == out )
+        {
+            return (NULL);
+        }
+        /*写索引先于存储内容读取*/
+        CPU_DMB();
+        off   = out & pFIFO->mask;
+        pHead = __MSGQ_HEAD_AT(pFIFO, off);
+        if ( __MSGQ_PAD != *pHead )
+        {
+            break;
+        }
+        /*跳过填充记录*/
+        out += pFIFO->mask + 1 - off;
+        pFIFO->out = out;
+    }
+    *len = *pHead;
+    return ( (uint8_t *)pHead + __MSGQ_HEAD_SIZE );
+}
+
+/**
+ * 丢弃下一条消息, 完成出队列
+ *
+ * @param pmsgq: 消息队列指针
+ */
+void msgq_Consume( MsgQueue_t *pmsgq )
+{
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pmsgq;
+size_t len;
+
+    if ( NULL != msgq_Peek(pmsgq, &len) )
+    {
+        /*存储内容读取先于读索引更新*/
+        CPU_DMB();
+        pFIFO->out = pFIFO->out + __MSGQ_RECORD_SIZE(len);
+    }
+}
+
+/**
+ * 接收一条消息
+ *
+ * @param pmsgq: 消息队列指针
+ *
+ * @param buffer: 保存消息内容的缓存地址
+ *
+ * @param size: 缓存大小, 消息长度超过缓存大小时, 超出部分被丢弃
+ *
+ * @return: 返回消息长度, 消息队列为空时返回0
+ */
+size_t msgq_Receive( MsgQueue_t *pmsgq, void *buffer, size_t size )
+{
+void *pMsg;
+size_t len = 0;
+
+    pMsg = msgq_Peek(pmsgq, &len);
+    if ( NULL != pMsg )
+    {
+        memcpy(buffer, pMsg, (len < size) ? len : size);
+        msgq_Consume(pmsgq);
+    }
+    return (len);
+}
+
+/**
+ * 判断消息队列是否为空, 仅由消费者调用
+ *
+ * @param pmsgq: 消息队列指针
+ *
+ * @return: 返回布尔值, true表示消息队列为空
+ */
+bool msgq_IsEmpty( MsgQueue_t *pmsgq )
+{
+size_t len;
+
+    return ( NULL == msgq_Peek(pmsgq, &len) );
+}
+
+/**
+ * 重置消息队列, 须在生产者和消费者均未访问消息队列时调用
+ *
+ * @param pmsgq: 消息队列指针
+ */
+void msgq_Reset( MsgQueue_t *pmsgq )
+{
+    fifo_SpscReset(pmsgq);
+}
@@ -0,0 +1,234 @@
+/*******************************************************************************
+* 文 件 名: cpulib_pool.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 固定大小内存块池
+*******************************************************************************/
+
+#include "cpulib_pool.h"
+/*******************************************************************************
+
+                                    数据结构
+
+*******************************************************************************/
+/*空闲内存块, 链表指针直接保存在空闲块内部, 已分配块不占用额外首部*/
+typedef struct pool_block PoolBlock_t;
+struct pool_block
+{
+    PoolBlock_t    *pNextFreeBlock;
+};
+/*内存池首部记录*/
+typedef struct pool_head PoolHead_t;
+struct pool_head
+{
+    PoolBlock_t    *pFreeList;              /*空闲内存块链表      */
+    uint8_t        *pStart;                 /*首个内存块地址      */
+    uint8_t        *pEnd;                   /*内存块结束地址      */
+    size_t          blockSize;              /*内存块大小          */
+    size_t          totalSize;              /*内存池内存总大小    */
+    size_t          freeBlocks;             /*空闲内存块数量      */
+    size_t          minimumEverFreeBlocks;  /*空闲内存块最小剩余量*/
+    bool            isrSafe;                /*是否使用临界区保护  */
+};
+
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+/*
+ * 对指定的内存大小, 进行字节对齐处理
+ * size:   给定的内存大小
+ * return: 字节对齐后的大小
+ */
+#define __POOL_GET_SIZE_ALIGNED(size)   \
+    ( ((size_t)(size) + (size_t)HEAP_BYTE_ALIGNMENT_MASK) & (~((size_t)HEAP_BYTE_ALIGNMENT_MASK)) )
+
+/*内存池首部结构体大小*/
+#define __POOL_HEAD_STRUCT_SIZE         __POOL_GET_SIZE_ALIGNED(sizeof(PoolHead_t))
+
+/*******************************************************************************
+
+                                  内存池操作函数
+
+*******************************************************************************/
+/**
+ * 创建内存池设备
+ *
+ * @param startAddr: 内存池内存起始地址
+ *
+ * @param totalSize: 内存池内存总大小
+ *
+ * @param blockSize: 内存块大小, 将被调整为满足字节对齐并且不小于一个指针的大小
+ *
+ * @param isrSafe: 若为true, 分配和释放使用CPU_EnterCritical()保护,
+ *                 可以同时在中断函数和线程函数中使用
+ *
+ * @return: 若创建成功, 返回内存池设备指针
+ *          若创建失败, 返回NULL
+ */
+PoolDev_t *pool_Create( uint8_t *startAddr, size_t totalSize, size_t blockSize, bool isrSafe )
+{
+PoolHead_t  *pPool = NULL;
+PoolBlock_t *pBlock;
+uint8_t     *pAligned;
+size_t       offset;
+size_t       freeSize;
+
+    offset   = (size_t)( (0 - (size_t)startAddr) & (size_t)HEAP_BYTE_ALIGNMENT_MASK );
+    pAligned = startAddr + offset;
+    if ( blockSize < sizeof(PoolBlock_t) )
+    {
+        blockSize = sizeof(PoolBlock_t);
+    }
+    blockSize = __POOL_GET_SIZE_ALIGNED(blockSize);
+
+    if ( (0 == blockSize) || (totalSize < offset + __POOL_HEAD_STRUCT_SIZE + blockSize) )
+    {
+        pPool = NULL;
+    }
+    else
+    {
+        /*分配内存池首部*/
+        freeSize = totalSize - offset - __POOL_HEAD_STRUCT_SIZE;
+        pPool = (PoolHead_t *)pAligned;
+        pPool->pStart     = pAligned + __POOL_HEAD_STRUCT_SIZE;
+        pPool->freeBlocks = freeSize / blockSize;
+        pPool->pEnd       = pPool->pStart + pPool->freeBlocks*blockSize;
+        pPool->blockSize  = blockSize;
+        pPool->totalSize  = totalSize;
+        pPool->minimumEverFreeBlocks = pPool->freeBlocks;
+        pPool->isrSafe    = isrSafe;
+        /*按地址顺序串联全部空闲内存块*/
+        pPool->pFreeList  = (PoolBlock_t *)pPool->pStart;
+        for ( pBlock = pPool->pFreeList;
+              ((uint8_t *)pBlock + blockSize) < pPool->pEnd;
+              pBlock = pBlock->pNextFreeBlock )
+        {
+            pBlock->pNextFreeBlock = (PoolBlock_t *)((uint8_t *)pBlock + blockSize);
+        }
+        pBlock->pNextFreeBlock = NULL;
+    }
+    return (pPool);
+}
+
+/**
+ * 获取内存池设备信息
+ *
+ * @param pool: 内存池设备指针
+ *
+ * @param info: 保存设备信息的结构体指针, 其中freeBlocks为空闲内存块数量
+ */
+void pool_GetInfo( PoolDev_t *pool, HeapInfo_t *info )
+{
+PoolHead_t *pPool;
+
+    /*参数检验*/
+    debug_assert(NULL != pool);
+    debug_assert(NULL != info);
+    pPool = (PoolHead_t *)pool;
+    info->totalSize  = pPool->totalSize;
+    info->freeSize   = pPool->freeBlocks * pPool->blockSize;
+    info->minimumEverFreeSize = pPool->minimumEverFreeBlocks * pPool->blockSize;
+    info->freeBlocks = pPool->freeBlocks;
+    info->reallocInPlace = 0;
+    info->reallocMerged  = 0;
+    info->reallocMoved   = 0;
+}
+
+/**
+ * 获取内存池内存块大小
+ *
+ * @param pool: 内存池设备指针
+ *
+ * @return: 返回对齐调整后的内存块大小
+ */
+size_t pool_GetBlockSize( PoolDev_t *pool )
+{
+    debug_assert(NULL != pool);
+    return ( ((PoolHead_t *)pool)->blockSize );
+}
+
+/*******************************************************************************
+
+                                 内存块分配函数
+
+*******************************************************************************/
+/**
+ * 从内存池中分配一个内存块
+ *
+ * @param pool: 内存池设备指针
+ *
+ * @return: 若分配成功, 返回内存块起始地址,
+ *          若内存池已空, 返回NULL
+ */
+void *pool_Alloc( PoolDev_t *pool )
+{
+PoolHead_t  *pPool;
+PoolBlock_t *pBlock;
+cpu_t cpu_sr = 0;
+
+    /*参数检验*/
+    debug_assert(NULL != pool);
+    pPool = (PoolHead_t *)pool;
+    if ( pPool->isrSafe )
+    {
+        cpu_sr = CPU_EnterCritical();
+    }
+    {
+        pBlock = pPool->pFreeList;
+        if ( NULL != pBlock )
+        {
+            pPool->pFreeList = pBlock->pNextFreeBlock;
+            pPool->freeBlocks--;
+            if ( pPool->minimumEverFreeBlocks > pPool->freeBlocks )
+            {
+                pPool->minimumEverFreeBlocks = pPool->freeBlocks;
+            }
+        }
+    }
+    if ( pPool->isrSafe )
+    {
+        CPU_ExitCritical(cpu_sr);
+    }
+    return (pBlock);
+}
+
+/**
+ * 将内存块释放回内存池
+ *
+ * @param pool: 内存池设备指针
+ *
+ * @param ptr: 待释放的内存块起始地址, 若为NULL则无动作
+ */
+void pool_Free( PoolDev_t *pool, void *ptr )
+{
+PoolHead_t  *pPool;
+PoolBlock_t *pBlock;
+cpu_t cpu_sr = 0;
+
+    if ( NULL != ptr )
+    {
+        /*参数检验*/
+        debug_assert(NULL != pool);
+        pPool  = (PoolHead_t *)pool;
+        pBlock = (PoolBlock_t *)ptr;
+        debug_assert((uint8_t *)ptr >= pPool->pStart);
+        debug_assert((uint8_t *)ptr <  pPool->pEnd);
+        debug_assert(0 == ((size_t)((uint8_t *)ptr - pPool->pStart) % pPool->blockSize));
+        if ( pPool->isrSafe )
+        {
+            cpu_sr = CPU_EnterCritical();
+        }
+        {
+            pBlock->pNextFreeBlock = pPool->pFreeList;
+            pPool->pFreeList = pBlock;
+            pPool->freeBlocks++;
+        }
+        if ( pPool->isrSafe )
+        {
+            CPU_ExitCritical(cpu_sr);
+        }
+    }
+}
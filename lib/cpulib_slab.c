@@ -0,0 +1,473 @@
+/*******************************************************************************
+* 文 件 名: cpulib_slab.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: Slab对象缓存, 建立在Heap设备之上
+*******************************************************************************/
+
+#include "cpulib_slab.h"
+#include "cpulib_list.h"
+/*******************************************************************************
+
+                                    数据结构
+
+*******************************************************************************/
+/*空闲对象, 链表指针直接保存在空闲对象内部*/
+typedef struct slab_obj SlabObj_t;
+struct slab_obj
+{
+    SlabObj_t      *pNextFreeObj;
+};
+/*
+ * slab首部, 位于slab起始位置; slab按自身大小对齐分配,
+ * 对象地址屏蔽低位即得到所属slab, 释放时间复杂度O(1)
+ */
+typedef struct slab Slab_t;
+struct slab
+{
+    ListNode_t      node;                   /*所在slab链表结点    */
+    SlabObj_t      *pFreeList;              /*空闲对象链表        */
+    size_t          inUse;                  /*已分配对象数量      */
+};
+/*对象缓存首部记录*/
+typedef struct slab_cache SlabCache_t;
+struct slab_cache
+{
+    ListNode_t      node;                   /*对象缓存链表结点    */
+    ListHead_t      partialList;            /*部分分配的slab链表  */
+    ListHead_t      fullList;               /*全部分配的slab链表  */
+    ListHead_t      emptyList;              /*全部空闲的slab链表  */
+    HeapDev_t      *pParent;                /*提供slab的Heap      */
+    const char     *name;                   /*对象缓存名称        */
+    SlabCtor_t      ctor;                   /*对象构造函数, 可为NULL*/
+    size_t          objSize;                /*对象大小            */
+    size_t          slabSize;               /*slab大小, 为2的幂   */
+    size_t          objsPerSlab;            /*每个slab的对象数量  */
+    size_t          slabCount;              /*slab数量            */
+    size_t          freeObjs;               /*空闲对象数量        */
+    size_t          minimumEverFreeObjs;    /*空闲对象最小剩余量  */
+};
+
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+/*
+ * 对指定的内存大小, 进行字节对齐处理
+ * size:   给定的内存大小
+ * return: 字节对齐后的大小
+ */
+#define __SLAB_GET_SIZE_ALIGNED(size)   \
+    ( ((size_t)(size) + (size_t)HEAP_BYTE_ALIGNMENT_MASK) & (~((size_t)HEAP_BYTE_ALIGNMENT_MASK)) )
+
+/*slab首部结构体大小*/
+#define __SLAB_STRUCT_SIZE              __SLAB_GET_SIZE_ALIGNED(sizeof(Slab_t))
+
+/*
+ * 获取对象所属的slab
+ * pCache: 对象缓存首部指针
+ * ptr:    对象地址
+ * return: slab首部指针
+ */
+#define __SLAB_OF_OBJECT(pCache, ptr)   \
+    ( (Slab_t *)((size_t)(ptr) & ~((pCache)->slabSize - 1)) )
+
+/*******************************************************************************
+
+                                    全局变量
+
+*******************************************************************************/
+/*全部对象缓存链表, 供slab_ShrinkAll()遍历*/
+static ListHead_t slabCacheList = { &slabCacheList, &slabCacheList };
+
+static Slab_t *prvSlabGrow(SlabCache_t *pCache);
+static void prvSlabRelease(SlabCache_t *pCache, Slab_t *pSlab);
+static size_t prvSlabReclaim(HeapDev_t *heap);
+
+/*******************************************************************************
+
+                                对象缓存操作函数
+
+*******************************************************************************/
+/**
+ * 创建对象缓存设备
+ *
+ * @param heap: 提供slab内存的Heap设备指针, 对象缓存首部同样从中分配
+ *
+ * @param name: 对象缓存名称, 仅保存指针, 须在对象缓存存续期间有效, 可为NULL
+ *
+ * @param objSize: 对象大小, 将被调整为满足字节对齐并且不小于一个指针的大小
+ *
+ * @param slabSize: slab大小, 将被向上调整为2的幂;
+ *                  若为0, 取容纳SLAB_DEFAULT_OBJECTS个对象的最小值
+ *
+ * @param ctor: 对象构造函数, 每次slab_Alloc()返回对象前调用, 可为NULL
+ *
+ * @note: slab通过heap_MallocAligned()按自身大小对齐分配,
+ *        对象缓存不使用临界区保护, 禁止在中断函数中使用
+ *
+ * @return: 若创建成功, 返回对象缓存设备指针
+ *          若创建失败, 返回NULL
+ */
+SlabDev_t *slab_Create( HeapDev_t *heap, const char *name, size_t objSize, size_t slabSize, SlabCtor_t ctor )
+{
+SlabCache_t *pCache = NULL;
+size_t wantedSize;
+
+    /*参数检验*/
+    debug_assert(NULL != heap);
+    if ( objSize < sizeof(SlabObj_t) )
+    {
+        objSize = sizeof(SlabObj_t);
+    }
+    objSize = __SLAB_GET_SIZE_ALIGNED(objSize);
+    if ( 0 == slabSize )
+    {
+        wantedSize = __SLAB_STRUCT_SIZE + SLAB_DEFAULT_OBJECTS*objSize;
+    }
+    else
+    {
+        wantedSize = slabSize;
+    }
+    /*slab大小向上调整为2的幂*/
+    for ( slabSize = 1; (slabSize < wantedSize) && (0 != slabSize); slabSize <<= 1 )
+    {
+    }
+
+    if ( (0 == objSize) || (0 == slabSize) || (slabSize < __SLAB_STRUCT_SIZE + objSize) )
+    {
+        pCache = NULL;
+    }
+    else
+    {
+        pCache = (SlabCache_t *)heap_Malloc(heap, sizeof(SlabCache_t));
+    }
+    if ( NULL != pCache )
+    {
+        list_Init(&pCache->node);
+        list_Init(&pCache->partialList);
+        list_Init(&pCache->fullList);
+        list_Init(&pCache->emptyList);
+        pCache->pParent     = heap;
+        pCache->name        = name;
+        pCache->ctor        = ctor;
+        pCache->objSize     = objSize;
+        pCache->slabSize    = slabSize;
+        pCache->objsPerSlab = (slabSize - __SLAB_STRUCT_SIZE) / objSize;
+        pCache->slabCount   = 0;
+        pCache->freeObjs    = 0;
+        pCache->minimumEverFreeObjs = 0;
+        list_AddTail(&slabCacheList, &pCache->node);
+    }
+    return (pCache);
+}
+
+/**
+ * 销毁对象缓存设备, 将全部slab及对象缓存首部归还给Heap
+ *
+ * @param cache: 对象缓存设备指针, 若为NULL则无动作
+ *
+ * @note: 销毁前应释放全部对象, 仍在使用的对象随slab一同失效
+ */
+void slab_Destroy( SlabDev_t *cache )
+{
+SlabCache_t *pCache;
+ListNode_t  *pos, *tmp;
+
+    if ( NULL != cache )
+    {
+        pCache = (SlabCache_t *)cache;
+        debug_assert(list_IsEmpty(&pCache->fullList));
+        debug_assert(list_IsEmpty(&pCache->partialList));
+        list_for_each_safe(pos, tmp, &pCache->fullList)
+        {
+            prvSlabRelease(pCache, list_entry(pos, Slab_t, node));
+        }
+        list_for_each_safe(pos, tmp, &pCache->partialList)
+        {
+            prvSlabRelease(pCache, list_entry(pos, Slab_t, node));
+        }
+        list_for_each_safe(pos, tmp, &pCache->emptyList)
+        {
+            prvSlabRelease(pCache, list_entry(pos, Slab_t, node));
+        }
+        list_Del(&pCache->node);
+        heap_Free(pCache->pParent, pCache);
+    }
+}
+
+/**
+ * 获取对象缓存设备信息
+ *
+ * @param cache: 对象缓存设备指针
+ *
+ * @param info: 保存设备信息的结构体指针, 其中totalSize为当前全部slab的大小,
+ *              freeSize为空闲对象的总大小, freeBlocks为空闲对象数量,
+ *              minimumEverFreeSize为最近一次增加slab之后空闲对象总大小的最小值
+ */
+void slab_GetInfo( SlabDev_t *cache, HeapInfo_t *info )
+{
+SlabCache_t *pCache;
+
+    /*参数检验*/
+    debug_assert(NULL != cache);
+    debug_assert(NULL != info);
+    pCache = (SlabCache_t *)cache;
+    info->totalSize  = pCache->slabCount * pCache->slabSize;
+    info->freeSize   = pCache->freeObjs * pCache->objSize;
+    info->minimumEverFreeSize = pCache->minimumEverFreeObjs * pCache->objSize;
+    info->freeBlocks = pCache->freeObjs;
+    info->reallocInPlace = 0;
+    info->reallocMerged  = 0;
+    info->reallocMoved   = 0;
+}
+
+/**
+ * 获取对象缓存名称
+ *
+ * @param cache: 对象缓存设备指针
+ *
+ * @return: 返回创建时指定的名称
+ */
+const char *slab_GetName( SlabDev_t *cache )
+{
+    debug_assert(NULL != cache);
+    return ( ((SlabCache_t *)cache)->name );
+}
+
+/**
+ * 获取对象缓存的对象大小
+ *
+ * @param cache: 对象缓存设备指针
+ *
+ * @return: 返回对齐调整后的对象大小
+ */
+size_t slab_GetObjectSize( SlabDev_t *cache )
+{
+    debug_assert(NULL != cache);
+    return ( ((SlabCache_t *)cache)->objSize );
+}
+
+/*******************************************************************************
+
+                                  对象分配函数
+
+*******************************************************************************/
+/**
+ * 从对象缓存中分配一个对象, 优先使用部分分配的slab, 其次为空闲slab,
+ * 均不可用时从Heap中分配新的slab; Heap内存不足时, 先将同一Heap上
+ * 全部对象缓存的空闲slab归还给Heap, 再重试一次
+ *
+ * @param cache: 对象缓存设备指针
+ *
+ * @return: 若分配成功, 返回对象起始地址,
+ *          若回收后Heap内存仍不足, 返回NULL
+ */
+void *slab_Alloc( SlabDev_t *cache )
+{
+SlabCache_t *pCache;
+Slab_t      *pSlab = NULL;
+SlabObj_t   *pObj  = NULL;
+
+    /*参数检验*/
+    debug_assert(NULL != cache);
+    pCache = (SlabCache_t *)cache;
+    if ( !list_IsEmpty(&pCache->partialList) )
+    {
+        pSlab = list_entry(pCache->partialList.next, Slab_t, node);
+    }
+    else if ( !list_IsEmpty(&pCache->emptyList) )
+    {
+        pSlab = list_entry(pCache->emptyList.next, Slab_t, node);
+        list_Del(&pSlab->node);
+        list_Add(&pCache->partialList, &pSlab->node);
+    }
+    else
+    {
+        pSlab = prvSlabGrow(pCache);
+        if ( (NULL == pSlab) && (0 != prvSlabReclaim(pCache->pParent)) )
+        {
+            pSlab = prvSlabGrow(pCache);
+        }
+    }
+
+    if ( NULL != pSlab )
+    {
+        pObj = pSlab->pFreeList;
+        debug_assert(NULL != pObj);
+        pSlab->pFreeList = pObj->pNextFreeObj;
+        pSlab->inUse++;
+        if ( pSlab->inUse == pCache->objsPerSlab )
+        {
+            list_Del(&pSlab->node);
+            list_Add(&pCache->fullList, &pSlab->node);
+        }
+        pCache->freeObjs--;
+        if ( pCache->minimumEverFreeObjs > pCache->freeObjs )
+        {
+            pCache->minimumEverFreeObjs = pCache->freeObjs;
+        }
+        if ( NULL != pCache->ctor )
+        {
+            (pCache->ctor)(pObj);
+        }
+    }
+    return (pObj);
+}
+
+/**
+ * 将对象释放回对象缓存, 时间复杂度O(1), 空闲的slab保留在缓存中,
+ * 由slab_Shrink()/slab_ShrinkAll()归还给Heap
+ *
+ * @param cache: 对象缓存设备指针
+ *
+ * @param ptr: 待释放的对象起始地址, 若为NULL则无动作
+ */
+void slab_Free( SlabDev_t *cache, void *ptr )
+{
+SlabCache_t *pCache;
+Slab_t      *pSlab;
+SlabObj_t   *pObj;
+
+    if ( NULL != ptr )
+    {
+        /*参数检验*/
+        debug_assert(NULL != cache);
+        pCache = (SlabCache_t *)cache;
+        pSlab  = __SLAB_OF_OBJECT(pCache, ptr);
+        pObj   = (SlabObj_t *)ptr;
+        debug_assert(0 != pSlab->inUse);
+        debug_assert((uint8_t *)ptr >= (uint8_t *)pSlab + __SLAB_STRUCT_SIZE);
+        debug_assert(0 == ((size_t)((uint8_t *)ptr - (uint8_t *)pSlab - __SLAB_STRUCT_SIZE) % pCache->objSize));
+
+        if ( pSlab->inUse == pCache->objsPerSlab )
+        {
+            list_Del(&pSlab->node);
+            list_Add(&pCache->partialList, &pSlab->node);
+        }
+        pObj->pNextFreeObj = pSlab->pFreeList;
+        pSlab->pFreeList = pObj;
+        pSlab->inUse--;
+        if ( 0 == pSlab->inUse )
+        {
+            list_Del(&pSlab->node);
+            list_Add(&pCache->emptyList, &pSlab->node);
+        }
+        pCache->freeObjs++;
+    }
+}
+
+/*******************************************************************************
+
+                                  内存回收函数
+
+*******************************************************************************/
+/**
+ * 将对象缓存中全部空闲slab归还给Heap
+ *
+ * @param cache: 对象缓存设备指针
+ *
+ * @return: 返回归还的slab数量
+ */
+size_t slab_Shrink( SlabDev_t *cache )
+{
+SlabCache_t *pCache;
+ListNode_t  *pos, *tmp;
+size_t count = 0;
+
+    debug_assert(NULL != cache);
+    pCache = (SlabCache_t *)cache;
+    list_for_each_safe(pos, tmp, &pCache->emptyList)
+    {
+        prvSlabRelease(pCache, list_entry(pos, Slab_t, node));
+        count++;
+    }
+    return (count);
+}
+
+/**
+ * 将全部对象缓存中的空闲slab归还给Heap, 用于内存不足时回收内存
+ *
+ * @return: 返回归还的slab总数
+ */
+size_t slab_ShrinkAll( void )
+{
+ListNode_t *pos;
+size_t count = 0;
+
+    list_for_each(pos, &slabCacheList)
+    {
+        count += slab_Shrink(list_entry(pos, SlabCache_t, node));
+    }
+    return (count);
+}
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/*从Heap中分配新的slab, 串联全部对象后加入部分分配链表*/
+static Slab_t *prvSlabGrow(SlabCache_t *pCache)
+{
+Slab_t    *pSlab;
+SlabObj_t *pObj;
+uint8_t   *pStart;
+size_t i;
+
+    pSlab = (Slab_t *)heap_MallocAligned(pCache->pParent, pCache->slabSize, pCache->slabSize);
+    if ( NULL != pSlab )
+    {
+        debug_assert(pSlab == __SLAB_OF_OBJECT(pCache, pSlab));
+        /*按地址顺序串联全部空闲对象*/
+        pStart = (uint8_t *)pSlab + __SLAB_STRUCT_SIZE;
+        for ( i = 0; i < pCache->objsPerSlab; i++ )
+        {
+            pObj = (SlabObj_t *)(pStart + i*pCache->objSize);
+            pObj->pNextFreeObj = (SlabObj_t *)(pStart + (i+1)*pCache->objSize);
+        }
+        ((SlabObj_t *)(pStart + (pCache->objsPerSlab-1)*pCache->objSize))->pNextFreeObj = NULL;
+        pSlab->pFreeList = (SlabObj_t *)pStart;
+        pSlab->inUse     = 0;
+        list_Init(&pSlab->node);
+        list_Add(&pCache->partialList, &pSlab->node);
+        pCache->slabCount++;
+        pCache->freeObjs += pCache->objsPerSlab;
+        /*增加slab后重新统计空闲对象最小剩余量*/
+        pCache->minimumEverFreeObjs = pCache->freeObjs;
+    }
+    return (pSlab);
+}
+
+/*将使用指定Heap的全部对象缓存中的空闲slab归还给Heap, 返回归还的slab数量*/
+static size_t prvSlabReclaim(HeapDev_t *heap)
+{
+ListNode_t *pos;
+SlabCache_t *pCache;
+size_t count = 0;
+
+    list_for_each(pos, &slabCacheList)
+    {
+        pCache = list_entry(pos, SlabCache_t, node);
+        if ( pCache->pParent == heap )
+        {
+            count += slab_Shrink(pCache);
+        }
+    }
+    return (count);
+}
+
+/*将slab从所在链表中移除并归还给Heap*/
+static void prvSlabRelease(SlabCache_t *pCache, Slab_t *pSlab)
+{
+    list_Del(&pSlab->node);
+    pCache->slabCount--;
+    pCache->freeObjs -= pCache->objsPerSlab - pSlab->inUse;
+    if ( pCache->minimumEverFreeObjs > pCache->freeObjs )
+    {
+        pCache->minimumEverFreeObjs = pCache->freeObjs;
+    }
+    heap_FreeAligned(pCache->pParent, pSlab);
+}
@@ -0,0 +1,269 @@
+/*******************************************************************************
+* 文 件 名: cpulib_wheel.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 分层时间轮, 用于节拍定时器管理
+*******************************************************************************/
+
+#include "cpulib_wheel.h"
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+/*槽序号掩码*/
+#define __WHEEL_SLOT_MASK           ( (tick_t)(WHEEL_SLOTS - 1) )
+
+/*
+ * 获取指定层覆盖的节拍数
+ * level:  层序号, 1..WHEEL_LEVELS
+ * return: 前level层共覆盖的节拍数
+ */
+#define __WHEEL_RANGE(level)        ( (tick_t)1 << (WHEEL_SLOT_BITS*(level)) )
+
+/*
+ * 获取节拍在指定层中对应的槽序号
+ * tick:   节拍
+ * level:  层序号
+ * return: 槽序号
+ */
+#define __WHEEL_INDEX(tick, level)  \
+    ( (uint8_t)(((tick) >> (WHEEL_SLOT_BITS*(level))) & __WHEEL_SLOT_MASK) )
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/**
+ * 按到期节拍将定时器放入对应的时间槽
+ *
+ * @param wheel: 时间轮指针
+ *
+ * @param timer: 定时器指针, 必须不在任何时间槽中
+ */
+static void prvWheelInsert(TimeWheel_t *wheel, WheelTimer_t *timer)
+{
+tick_t expire = timer->expire;
+tick_t delta  = (tick_t)(expire - wheel->now);
+uint8_t level;
+
+    /*超出时间轮覆盖范围, 暂存于最高层最远的槽, 级联时重新放置*/
+    if ( delta >= __WHEEL_RANGE(WHEEL_LEVELS) )
+    {
+        expire = wheel->now + __WHEEL_RANGE(WHEEL_LEVELS) - 1;
+        delta  = __WHEEL_RANGE(WHEEL_LEVELS) - 1;
+    }
+    for ( level = 0; level < WHEEL_LEVELS - 1; level++ )
+    {
+        if ( delta < __WHEEL_RANGE(level + 1) )
+        {
+            break;
+        }
+    }
+    list_AddTail(&wheel->slot[level][__WHEEL_INDEX(expire, level)], &timer->node);
+}
+
+/**
+ * 将高层时间槽中的定时器级联到低层
+ *
+ * @param wheel: 时间轮指针
+ *
+ * @param level: 层序号, 1..WHEEL_LEVELS-1
+ */
+static void prvWheelCascade(TimeWheel_t *wheel, uint8_t level)
+{
+ListHead_t *pSlot = &wheel->slot[level][__WHEEL_INDEX(wheel->now, level)];
+ListNode_t *pNode;
+
+    while ( !list_IsEmpty(pSlot) )
+    {
+        pNode = pSlot->next;
+        list_Del(pNode);
+        prvWheelInsert(wheel, list_entry(pNode, WheelTimer_t, node));
+    }
+}
+
+/*******************************************************************************
+
+                                    操作函数
+
+*******************************************************************************/
+/**
+ * 初始化时间轮
+ *
+ * @param wheel: 时间轮指针
+ */
+void wheel_Init( TimeWheel_t *wheel )
+{
+uint8_t level, index;
+
+    debug_assert(WHEEL_SLOT_BITS*WHEEL_LEVELS < 8*sizeof(tick_t));
+    wheel->now = 0;
+    for ( level = 0; level < WHEEL_LEVELS; level++ )
+    {
+        for ( index = 0; index < WHEEL_SLOTS; index++ )
+        {
+            list_Init(&wheel->slot[level][index]);
+        }
+    }
+}
+
+/**
+ * 初始化定时器
+ *
+ * @param timer: 定时器指针
+ *
+ * @param handler: 到期处理函数
+ */
+void wheel_TimerInit( WheelTimer_t *timer, WheelHandler_t handler )
+{
+    debug_assert(NULL != handler);
+    list_Init(&timer->node);
+    timer->expire  = 0;
+    timer->period  = 0;
+    timer->handler = handler;
+}
+
+/**
+ * 启动定时器
+ *
+ * @param wheel: 时间轮指针
+ *
+ * @param timer: 定时器指针, 必须未启动
+ *
+ * @param delay: 首次到期前的节拍数, 不能为0
+ *
+ * @param period: 到期后的重装周期, 为0时只到期一次
+ */
+void wheel_Add( TimeWheel_t *wheel, WheelTimer_t *timer, tick_t delay, tick_t period )
+{
+    debug_assert(0 != delay);
+    debug_assert(list_IsEmpty(&timer->node));
+    timer->expire = wheel->now + delay;
+    timer->period = period;
+    prvWheelInsert(wheel, timer);
+}
+
+/**
+ * 停止定时器, O(1)
+ *
+ * @param timer: 定时器指针, 必须已初始化
+ *
+ * @return: 返回布尔值, true表示定时器停止前处于启动状态
+ */
+bool wheel_Del( WheelTimer_t *timer )
+{
+    if ( list_IsEmpty(&timer->node) )
+    {
+        return (false);
+    }
+    list_Del(&timer->node);
+    return (true);
+}
+
+/**
+ * 判断定时器是否处于启动状态
+ *
+ * @param timer: 定时器指针, 必须已初始化
+ *
+ * @return: 返回布尔值, true表示定时器已启动且尚未到期(单次定时器)或未被停止
+ */
+bool wheel_IsActive( WheelTimer_t *timer )
+{
+    return ( !list_IsEmpty(&timer->node) );
+}
+
+/**
+ * 时间轮节拍处理, 调用到期定时器的处理函数
+ *
+ * @param wheel: 时间轮指针
+ *
+ * @note: 周期定时器在调用处理函数之前重新放入时间轮,
+ *        每个节拍的开销与到期定时器数量相关, 与定时器总数无关
+ */
+void wheel_Tick( TimeWheel_t *wheel )
+{
+ListHead_t *pSlot;
+ListNode_t *pNode;
+WheelTimer_t *pTimer;
+uint8_t level;
+
+    wheel->now++;
+    /*低层转满一圈时, 依次级联高层对应的时间槽*/
+    for ( level = 1; level < WHEEL_LEVELS; level++ )
+    {
+        if ( 0 != __WHEEL_INDEX(wheel->now, level - 1) )
+        {
+            break;
+        }
+        prvWheelCascade(wheel, level);
+    }
+    /*处理第0层当前时间槽*/
+    pSlot = &wheel->slot[0][__WHEEL_INDEX(wheel->now, 0)];
+    while ( !list_IsEmpty(pSlot) )
+    {
+        pNode  = pSlot->next;
+        pTimer = list_entry(pNode, WheelTimer_t, node);
+        debug_assert(pTimer->expire == wheel->now);
+        list_Del(pNode);
+        if ( 0 != pTimer->period )
+        {
+            pTimer->expire += pTimer->period;
+            prvWheelInsert(wheel, pTimer);
+        }
+        (pTimer->handler)(pTimer);
+    }
+}
+
+/**
+ * 获取距离下一个需要处理的节拍的节拍数
+ *
+ * @param wheel: 时间轮指针
+ *
+ * @note: 需要处理的节拍指有定时器到期, 或需要级联非空时间槽的节拍;
+ *        只检查各层下一圈内被访问的时间槽, 开销与定时器数量无关
+ *
+ * @return: 返回值n(n>=1)表示之后的n-1个节拍均无需处理, 可由wheel_Skip()跳过;
+ *          没有需要处理的节拍时返回时间轮覆盖的节拍数
+ */
+tick_t wheel_NextExpiry( TimeWheel_t *wheel )
+{
+tick_t next = __WHEEL_RANGE(WHEEL_LEVELS);
+tick_t tick, step;
+uint8_t level, i;
+
+    for ( level = 0; level < WHEEL_LEVELS; level++ )
+    {
+        /*第level层的时间槽每step个节拍被访问一次*/
+        step = __WHEEL_RANGE(level);
+        tick = (wheel->now & ~(step - 1)) + step;
+        for ( i = 0; i < WHEEL_SLOTS; i++, tick += step )
+        {
+            if ( (tick_t)(tick - wheel->now) >= next )
+            {
+                break;
+            }
+            if ( !list_IsEmpty(&wheel->slot[level][__WHEEL_INDEX(tick, level)]) )
+            {
+                next = tick - wheel->now;
+                break;
+            }
+        }
+    }
+    return (next);
+}
+
+/**
+ * 跳过若干无需处理的节拍, 不调用任何定时器处理函数
+ *
+ * @param wheel: 时间轮指针
+ *
+ * @param n: 跳过的节拍数, 必须小于wheel_NextExpiry()的返回值
+ */
+void wheel_Skip( TimeWheel_t *wheel, tick_t n )
+{
+    debug_assert(n < wheel_NextExpiry(wheel));
+    wheel->now += n;
+}
@@ -0,0 +1,34 @@
+/*******************************************************************************
+* 文 件 名: cpulib_arena.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 线性(bump)内存分配, 支持标记与整体释放
+*******************************************************************************/
+
+#ifndef __CPULIB_ARENA_H
+#define __CPULIB_ARENA_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpulib_def.h"
+#include "cpulib_heap.h"
+
+/* 数据类型 ------------------------------------------------------------------*/
+/*Arena设备类型*/
+typedef void ArenaDev_t;
+/*Arena分配位置标记类型*/
+typedef size_t ArenaMark_t;
+
+/* 操作函数 ------------------------------------------------------------------*/
+/*Arena设备操作函数*/
+ArenaDev_t *arena_Create( uint8_t *startAddr, size_t totalSize );
+ArenaDev_t *arena_CreateFromHeap( HeapDev_t *heap, size_t totalSize );
+void arena_Destroy( ArenaDev_t *arena );
+void arena_GetInfo( ArenaDev_t *arena, HeapInfo_t *info );
+/*内存分配函数*/
+void *arena_Alloc( ArenaDev_t *arena, size_t size );
+ArenaMark_t arena_GetMark( ArenaDev_t *arena );
+void arena_Release( ArenaDev_t *arena, ArenaMark_t mark );
+void arena_Reset( ArenaDev_t *arena );
+
+#endif  /* __CPULIB_ARENA_H */
@@ -0,0 +1,53 @@
+/*******************************************************************************
+* 文 件 名: cpulib_dbuf.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 双缓冲(多缓冲), 用于DMA等块数据流
+*******************************************************************************/
+
+#ifndef __CPULIB_DBUF_H
+#define __CPULIB_DBUF_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpulib_def.h"
+
+/* 多缓冲参数 ----------------------------------------------------------------*/
+/*
+ * DBUF_MAX_COUNT: 单个多缓冲对象最多包含的缓冲区数量, 可在cpu_config.h中重新定义
+ */
+#ifndef DBUF_MAX_COUNT
+    #define DBUF_MAX_COUNT          ( 4 )
+#endif
+
+/* 数据结构 ------------------------------------------------------------------*/
+/*
+ * 多缓冲对象, 各缓冲区依次首尾相接, 生产者(中断函数, DMA)按顺序循环填充,
+ * 消费者(线程函数)按填充顺序获取已填满的缓冲区, 处理完毕后归还;
+ * 生产者进入尚未被消费者获取或归还的缓冲区时记为一次溢出
+ */
+typedef struct dbuf DBuf_t;
+struct dbuf
+{
+    uint8_t            *data;                   /* 存储地址         */
+    size_t              bufSize;                /* 单个缓冲区大小   */
+    uint8_t             count;                  /* 缓冲区数量       */
+    uint8_t             fill;                   /* 生产者填充的缓冲区 */
+    uint8_t             next;                   /* 消费者下一个获取的缓冲区 */
+    volatile uint8_t    state[DBUF_MAX_COUNT];  /* 各缓冲区状态     */
+    volatile size_t     overrun;                /* 溢出次数         */
+};
+
+/* 操作函数 ------------------------------------------------------------------*/
+void dbuf_Init( DBuf_t *pdbuf, void *mem, size_t bufSize, uint8_t count );
+size_t dbuf_GetOverrun( DBuf_t *pdbuf );
+/*生产者操作函数, 在中断函数中调用*/
+void *dbuf_GetFillBuffer( DBuf_t *pdbuf );
+void *dbuf_ProducerDone( DBuf_t *pdbuf );
+void dbuf_OnHalfTransfer( DBuf_t *pdbuf );
+void dbuf_OnTransferComplete( DBuf_t *pdbuf );
+/*消费者操作函数, 在线程函数中调用*/
+void *dbuf_Acquire( DBuf_t *pdbuf );
+bool dbuf_Release( DBuf_t *pdbuf, void *buffer );
+
+#endif  /* __CPULIB_DBUF_H */
@@ -22,6 +22,7 @@ struct __fifo
     size_t      count;  /* 已使用量 */
     size_t      esize;  /* 元素大小 */
     void       *data;   /* 存储地址 */
+    size_t      dropped;/* 覆盖丢弃的元素数 */
 };
 
 #define __STRUCT_FIFO_COMMON(datatype)  \
@@ -57,13 +58,174 @@ struct __fifo
     tmp_pfifo->count            = 0;                        \
     tmp_pfifo->esize            = tmp_esize;                \
     tmp_pfifo->data             = tmp_data;                 \
+    tmp_pfifo->dropped          = 0;                        \
 } while (0)
 
+/* 单生产者单消费者FIFO ------------------------------------------------------*/
+/*
+ * 单生产者单消费者(SPSC)FIFO, 写索引仅由生产者修改, 读索引仅由消费者修改,
+ * 两者自由递增并以掩码取得存储位置, 不共享计数量, 生产者与消费者分别位于
+ * 中断函数和线程函数时无需临界区保护; 多个生产者或多个消费者时仍需互斥
+ */
+typedef void SPSC_FIFO_t;
+struct __spsc_fifo
+{
+    volatile size_t in;     /* 写索引   */
+    volatile size_t out;    /* 读索引   */
+    size_t      mask;       /* 总元素数-1 */
+    size_t      esize;      /* 元素大小 */
+    void       *data;       /* 存储地址 */
+};
+
+#define __STRUCT_SPSC_FIFO_COMMON(datatype) \
+    union {                                 \
+        struct __spsc_fifo  fifo;           \
+        datatype           *type;           \
+    }
+
+/*
+ * SPSC FIFO结构体类型
+ * type: FIFO元素类型
+ * size: FIFO元素个数, 必须为2的幂, 否则编译报错
+ */
+#define STRUCT_SPSC_FIFO(type, size)                        \
+    struct {                                                \
+        __STRUCT_SPSC_FIFO_COMMON(type);                    \
+        type        buf[((size)&((size)-1)) ? -1 : (size)]; \
+    }
+
+/*
+ * 初始化SPSC FIFO
+ * pfifo: FIFO结构体指针, STRUCT_SPSC_FIFO(type, size)的指针类型
+ */
+#define INIT_SPSC_FIFO(pfifo)   do                          \
+{                                                           \
+    struct __spsc_fifo *tmp_pfifo = &((pfifo)->fifo);       \
+    const size_t tmp_end        = ARRAY_SIZE((pfifo)->buf); \
+    const size_t tmp_esize      = sizeof(*((pfifo)->type)); \
+    void * const tmp_data       = (pfifo)->buf;             \
+    tmp_pfifo->in               = 0;                        \
+    tmp_pfifo->out              = 0;                        \
+    tmp_pfifo->mask             = tmp_end - 1;              \
+    tmp_pfifo->esize            = tmp_esize;                \
+    tmp_pfifo->data             = tmp_data;                 \
+} while (0)
+
+/* 多生产者单消费者FIFO ------------------------------------------------------*/
+/*
+ * 多生产者单消费者(MPSC)FIFO, 每个元素位置附带序号, 生产者以cpu_AtomicCAS()
+ * 竞争写索引预留位置, 写入元素后更新序号发布; 消费者按序号判断元素是否就绪,
+ * 多个中断函数作为生产者时无需临界区保护
+ */
+typedef void MPSC_FIFO_t;
+struct __mpsc_fifo
+{
+    volatile size_t in;     /* 写索引   */
+    size_t      out;        /* 读索引   */
+    size_t      mask;       /* 总元素数-1 */
+    size_t      esize;      /* 元素大小 */
+    volatile size_t *seq;   /* 序号地址 */
+    void       *data;       /* 存储地址 */
+};
+
+#define __STRUCT_MPSC_FIFO_COMMON(datatype) \
+    union {                                 \
+        struct __mpsc_fifo  fifo;           \
+        datatype           *type;           \
+    }
+
+/*
+ * MPSC FIFO结构体类型
+ * type: FIFO元素类型
+ * size: FIFO元素个数, 必须为2的幂, 否则编译报错
+ */
+#define STRUCT_MPSC_FIFO(type, size)                                    \
+    struct {                                                            \
+        __STRUCT_MPSC_FIFO_COMMON(type);                                \
+        volatile size_t seq[((size)&((size)-1)) ? -1 : (size)];         \
+        type        buf[size];                                          \
+    }
+
+/*
+ * 初始化MPSC FIFO
+ * pfifo: FIFO结构体指针, STRUCT_MPSC_FIFO(type, size)的指针类型
+ */
+#define INIT_MPSC_FIFO(pfifo)   do                          \
+{                                                           \
+    struct __mpsc_fifo *tmp_pfifo = &((pfifo)->fifo);       \
+    const size_t tmp_end        = ARRAY_SIZE((pfifo)->buf); \
+    const size_t tmp_esize      = sizeof(*((pfifo)->type)); \
+    size_t tmp_i;                                           \
+    tmp_pfifo->in               = 0;                        \
+    tmp_pfifo->out              = 0;                        \
+    tmp_pfifo->mask             = tmp_end - 1;              \
+    tmp_pfifo->esize            = tmp_esize;                \
+    tmp_pfifo->seq              = (pfifo)->seq;             \
+    tmp_pfifo->data             = (pfifo)->buf;             \
+    for ( tmp_i = 0; tmp_i < tmp_end; tmp_i++ )             \
+    {                                                       \
+        (pfifo)->seq[tmp_i]     = tmp_i;                    \
+    }                                                       \
+} while (0)
+
+/* 阻塞FIFO ------------------------------------------------------------------*/
+/*无限等待*/
+#define FIFO_WAIT_FOREVER       ( (tick_t)~((tick_t)0) )
+
+/*FIFO通知函数类型*/
+typedef void (*FifoNotify_t) (void *arg);
+/*获取当前节拍计数的函数类型, 计数允许回绕*/
+typedef tick_t (*FifoTickHook_t) (void);
+/*等待期间调用的空闲函数类型, 如进入睡眠或让出调度器*/
+typedef void (*FifoIdleHook_t) (void);
+
+/*
+ * 阻塞FIFO, 在普通FIFO之上提供带超时的进/出队列及水位通知,
+ * 每次进/出队列使用CPU_EnterCritical()保护, 生产者与消费者可分别位于中断函数和线程函数;
+ * 已使用量升至highWater时调用onData通知消费者, 降至lowWater时调用onSpace通知生产者
+ */
+typedef struct fifo_wait FifoWait_t;
+struct fifo_wait
+{
+    FIFO_t         *fifo;       /* 普通FIFO     */
+    size_t          highWater;  /* 数据水位     */
+    size_t          lowWater;   /* 空间水位     */
+    FifoNotify_t    onData;     /* 数据通知函数 */
+    FifoNotify_t    onSpace;    /* 空间通知函数 */
+    void           *arg;        /* 通知函数参数 */
+};
+
+/*fifo_Search/fifo_SpscSearch未找到元素时的返回值*/
+#define FIFO_NOT_FOUND          ( ~((size_t)0) )
+
 /* 操作函数 ------------------------------------------------------------------*/
 void fifo_Reset( FIFO_t *pfifo );
 size_t fifo_In( FIFO_t *pfifo, const void *buffer, size_t len );
 size_t fifo_Out( FIFO_t *pfifo, void *buffer, size_t len );
 size_t fifo_Peek( FIFO_t *pfifo, void *buffer, size_t len );
+size_t fifo_InOverwrite( FIFO_t *pfifo, const void *buffer, size_t len );
+size_t fifo_GetDropped( FIFO_t *pfifo );
+
+/*FIFO随机访问函数, 偏移均相对于下一个出队列元素*/
+size_t fifo_PeekAt( FIFO_t *pfifo, size_t offset, void *buffer, size_t len );
+size_t fifo_Skip( FIFO_t *pfifo, size_t len );
+size_t fifo_Search( FIFO_t *pfifo, size_t offset, const void *element );
+size_t fifo_SpscPeekAt( SPSC_FIFO_t *pfifo, size_t offset, void *buffer, size_t len );
+size_t fifo_SpscSkip( SPSC_FIFO_t *pfifo, size_t len );
+size_t fifo_SpscSearch( SPSC_FIFO_t *pfifo, size_t offset, const void *element );
+
+/*MPSC FIFO操作函数, In可由多个生产者同时调用, Out仅由消费者调用*/
+bool fifo_MpscIn( MPSC_FIFO_t *pfifo, const void *element );
+bool fifo_MpscOut( MPSC_FIFO_t *pfifo, void *element );
+bool fifo_MpscIsEmpty( MPSC_FIFO_t *pfifo );
+
+/*阻塞FIFO操作函数*/
+void fifo_SetWaitHooks( FifoTickHook_t getTick, FifoIdleHook_t idle );
+void fifo_WaitInit( FifoWait_t *pwait, FIFO_t *pfifo );
+void fifo_WaitSetWatermark( FifoWait_t *pwait, size_t highWater, FifoNotify_t onData,
+                            size_t lowWater, FifoNotify_t onSpace, void *arg );
+size_t fifo_InWait( FifoWait_t *pwait, const void *buffer, size_t len, tick_t timeout );
+size_t fifo_OutWait( FifoWait_t *pwait, void *buffer, size_t len, tick_t timeout );
 
 bool fifo_IsEmpty( FIFO_t *pfifo );
 bool fifo_IsFull( FIFO_t *pfifo );
@@ -71,4 +233,108 @@ size_t fifo_GetCount( FIFO_t *pfifo );
 size_t fifo_GetTotal( FIFO_t *pfifo );
 size_t fifo_GetAvail( FIFO_t *pfifo );
 
+/*FIFO零复制操作函数*/
+void *fifo_InReserve( FIFO_t *pfifo, size_t *len );
+void fifo_InCommit( FIFO_t *pfifo, size_t len );
+void *fifo_OutPeekLinear( FIFO_t *pfifo, size_t *len );
+void fifo_OutConsume( FIFO_t *pfifo, size_t len );
+
+/*SPSC FIFO操作函数, In仅由生产者调用, Out/Peek仅由消费者调用*/
+void fifo_SpscReset( SPSC_FIFO_t *pfifo );
+size_t fifo_SpscIn( SPSC_FIFO_t *pfifo, const void *buffer, size_t len );
+size_t fifo_SpscOut( SPSC_FIFO_t *pfifo, void *buffer, size_t len );
+size_t fifo_SpscPeek( SPSC_FIFO_t *pfifo, void *buffer, size_t len );
+
+bool fifo_SpscIsEmpty( SPSC_FIFO_t *pfifo );
+bool fifo_SpscIsFull( SPSC_FIFO_t *pfifo );
+size_t fifo_SpscGetCount( SPSC_FIFO_t *pfifo );
+size_t fifo_SpscGetTotal( SPSC_FIFO_t *pfifo );
+size_t fifo_SpscGetAvail( SPSC_FIFO_t *pfifo );
+
+/*SPSC FIFO零复制操作函数, Reserve/Commit仅由生产者调用, PeekLinear/Consume仅由消费者调用*/
+void *fifo_SpscInReserve( SPSC_FIFO_t *pfifo, size_t *len );
+void fifo_SpscInCommit( SPSC_FIFO_t *pfifo, size_t len );
+void *fifo_SpscOutPeekLinear( SPSC_FIFO_t *pfifo, size_t *len );
+void fifo_SpscOutConsume( SPSC_FIFO_t *pfifo, size_t len );
+
+/* 类型化快速操作 ------------------------------------------------------------*/
+/*
+ * 生成指定元素类型的单元素进/出队列静态内联函数, 直接读写存储区,
+ * 不调用memcpy; FIFO的元素类型须与type相同:
+ *   bool fifo_Put##name( FIFO_t *pfifo, type val );        进队列, 已满返回false
+ *   bool fifo_Get##name( FIFO_t *pfifo, type *pval );      出队列, 为空返回false
+ *   bool fifo_SpscPut##name( SPSC_FIFO_t *pfifo, type val );   仅由生产者调用
+ *   bool fifo_SpscGet##name( SPSC_FIFO_t *pfifo, type *pval ); 仅由消费者调用
+ * name: 函数名后缀
+ * type: FIFO元素类型
+ */
+#define FIFO_DEFINE_TYPED(name, type)                                       \
+STATIC_INLINE bool fifo_Put##name( FIFO_t *pfifo, type val )                \
+{                                                                           \
+struct __fifo *pFIFO = (struct __fifo *)pfifo;                              \
+    debug_assert(sizeof(type) == pFIFO->esize);                             \
+    if ( pFIFO->count >= pFIFO->total )                                     \
+    {                                                                       \
+        return (false);                                                     \
+    }                                                                       \
+    ((type *)(pFIFO->data))[pFIFO->in] = val;                               \
+    if ( ++(pFIFO->in) >= pFIFO->total )                                    \
+    {                                                                       \
+        pFIFO->in = 0;                                                      \
+    }                                                                       \
+    pFIFO->count++;                                                         \
+    return (true);                                                          \
+}                                                                           \
+STATIC_INLINE bool fifo_Get##name( FIFO_t *pfifo, type *pval )              \
+{                                                                           \
+struct __fifo *pFIFO = (struct __fifo *)pfifo;                              \
+    debug_assert(sizeof(type) == pFIFO->esize);                             \
+    if ( 0 == pFIFO->count )                                                \
+    {                                                                       \
+        return (false);                                                     \
+    }                                                                       \
+    *pval = ((type *)(pFIFO->data))[pFIFO->out];                            \
+    if ( ++(pFIFO->out) >= pFIFO->total )                                   \
+    {                                                                       \
+        pFIFO->out = 0;                                                     \
+    }                                                                       \
+    pFIFO->count--;                                                         \
+    return (true);                                                          \
+}                                                                           \
+STATIC_INLINE bool fifo_SpscPut##name( SPSC_FIFO_t *pfifo, type val )       \
+{                                                                           \
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;                    \
+size_t in = pFIFO->in;                                                      \
+    debug_assert(sizeof(type) == pFIFO->esize);                             \
+    if ( (in - pFIFO->out) > pFIFO->mask )                                  \
+    {                                                                       \
+        return (false);                                                     \
+    }                                                                       \
+    CPU_DMB();                                                              \
+    ((type *)(pFIFO->data))[in & pFIFO->mask] = val;                        \
+    CPU_DMB();                                                              \
+    pFIFO->in = in + 1;                                                     \
+    return (true);                                                          \
+}                                                                           \
+STATIC_INLINE bool fifo_SpscGet##name( SPSC_FIFO_t *pfifo, type *pval )     \
+{                                                                           \
+struct __spsc_fifo *pFIFO = (struct __spsc_fifo *)pfifo;                    \
+size_t out = pFIFO->out;                                                    \
+    debug_assert(sizeof(type) == pFIFO->esize);                             \
+    if ( pFIFO->in == out )                                                 \
+    {                                                                       \
+        return (false);                                                     \
+    }                                                                       \
+    CPU_DMB();                                                              \
+    *pval = ((type *)(pFIFO->data))[out & pFIFO->mask];                     \
+    CPU_DMB();                                                              \
+    pFIFO->out = out + 1;                                                   \
+    return (true);                                                          \
+}
+
+/*1/2/4字节元素的类型化快速操作*/
+FIFO_DEFINE_TYPED(U8,  uint8_t)
+FIFO_DEFINE_TYPED(U16, uint16_t)
+FIFO_DEFINE_TYPED(U32, uint32_t)
+
 #endif  /* __CPULIB_FIFO_H */
@@ -16,9 +16,78 @@
 #define HEAP_BYTE_ALIGNMENT         ( CPU_BYTE_ALIGNMENT )
 #define HEAP_BYTE_ALIGNMENT_MASK    ( HEAP_BYTE_ALIGNMENT-1 )
 
+/* 边界标记 ------------------------------------------------------------------*/
+/*
+ * HEAP_USE_BOUNDARY_TAG: 首次适应算法在内存块尾部附加边界标记(sizeof(size_t)),
+ *                        heap_Free可直接找到物理相邻的内存块并合并, 时间复杂度O(1),
+ *                        空闲链表改为无序双向链表; 默认在字节对齐大于1时使能,
+ *                        可在cpu_config.h中定义为0, 保持较小的内存块开销
+ */
+#ifndef HEAP_USE_BOUNDARY_TAG
+    #if ( HEAP_BYTE_ALIGNMENT > 1 )
+        #define HEAP_USE_BOUNDARY_TAG   ( 1 )
+    #else
+        #define HEAP_USE_BOUNDARY_TAG   ( 0 )
+    #endif
+#endif
+
+/* TLSF参数 ------------------------------------------------------------------*/
+/*
+ * HEAP_TLSF_SL_INDEX_COUNT_LOG2: 每一级(一级索引)划分的二级链表数量(log2), 不超过4
+ * HEAP_TLSF_FL_INDEX_MAX:        可管理的最大内存块为2^(HEAP_TLSF_FL_INDEX_MAX+1)字节,
+ *                                需小于size_t的最高位
+ * 可在cpu_config.h中重新定义
+ */
+#if SIZE_MAX > 0xFFFFU
+    #ifndef HEAP_TLSF_SL_INDEX_COUNT_LOG2
+        #define HEAP_TLSF_SL_INDEX_COUNT_LOG2   ( 4 )
+    #endif
+    #ifndef HEAP_TLSF_FL_INDEX_MAX
+        #define HEAP_TLSF_FL_INDEX_MAX          ( 20 )
+    #endif
+#else
+    #ifndef HEAP_TLSF_SL_INDEX_COUNT_LOG2
+        #define HEAP_TLSF_SL_INDEX_COUNT_LOG2   ( 3 )
+    #endif
+    #ifndef HEAP_TLSF_FL_INDEX_MAX
+        #define HEAP_TLSF_FL_INDEX_MAX          ( 14 )
+    #endif
+#endif
+
+/* 分配追踪 ------------------------------------------------------------------*/
+/*
+ * HEAP_USE_TRACE: 使能分配追踪, heap_TraceStart指定的环形缓冲区依次记录
+ *                 每次分配/释放事件(HeapTraceEvent_t), 缓冲区满后覆盖最旧的事件;
+ *                 默认关闭, 关闭时Heap首部及各操作函数均无额外开销
+ * CPU_RETURN_ADDRESS(): 由cpu_port.h提供, 获取当前函数的返回地址,
+ *                       未提供时调用者地址记录为NULL
+ */
+#ifndef HEAP_USE_TRACE
+    #define HEAP_USE_TRACE              ( 0 )
+#endif
+#if HEAP_USE_TRACE && !defined(CPU_RETURN_ADDRESS)
+    #define CPU_RETURN_ADDRESS()        ( (void *)0 )
+#endif
+
+/* 碎片统计 ------------------------------------------------------------------*/
+/*
+ * 空闲块大小直方图按2的幂分组, 第i组统计大小位于
+ * [2^(i+HEAP_FRAG_BUCKET_SHIFT), 2^(i+HEAP_FRAG_BUCKET_SHIFT+1))的空闲块,
+ * 第0组同时包含更小的空闲块, 最后一组同时包含更大的空闲块
+ */
+#define HEAP_FRAG_BUCKET_SHIFT      ( 4 )
+#define HEAP_FRAG_BUCKET_COUNT      ( 12 )
+
 /* 数据类型 ------------------------------------------------------------------*/
 /*Heap设备类型*/
 typedef void HeapDev_t;
+/*Heap分配算法类型*/
+typedef enum
+{
+    HEAP_ALGO_FIRSTFIT = 0,         /*首次适应算法                  */
+    HEAP_ALGO_TLSF,                 /*两级分离适应算法, O(1)分配释放*/
+    HEAP_ALGO_REGIONS,              /*多区域Heap, 仅由heap_CreateRegions创建*/
+} HeapAlgo_t;
 /*Heap信息类型*/
 typedef struct heap_info HeapInfo_t;
 struct heap_info
@@ -27,16 +96,87 @@ struct heap_info
     size_t  freeSize;               /*Heap未分配内存大小  */
     size_t  minimumEverFreeSize;    /*Heap内存最小剩余量  */
     size_t  freeBlocks;             /*Heap不连续空闲块数量*/
+    size_t  reallocInPlace;         /*realloc原地完成次数(缩小或吸收后一空闲块)*/
+    size_t  reallocMerged;          /*realloc吸收前一空闲块并前移数据的次数    */
+    size_t  reallocMoved;           /*realloc重新分配并复制数据的次数          */
+};
+
+/*Heap碎片信息类型*/
+typedef struct heap_frag_info HeapFragInfo_t;
+struct heap_frag_info
+{
+    size_t  freeBlocks;             /*空闲块数量                */
+    size_t  largestFreeBlock;       /*最大空闲块大小(含块首部)  */
+    size_t  histogram[HEAP_FRAG_BUCKET_COUNT];  /*空闲块大小直方图*/
+};
+
+/*
+ * Heap追踪事件类型, 追踪缓冲区即为该结构体数组, 按目标CPU的字长和字节序原样保存,
+ * 导出时直接转储缓冲区内存, 并附带heap_TraceGetCount的返回值n及缓冲区容量c:
+ *   caller: 调用Heap函数处的返回地址, 可对照map文件定位调用者
+ *   ptr:    分配得到/被释放的内存地址, 分配失败时为NULL
+ *   size:   分配事件为请求的大小; 释放事件为HEAP_TRACE_FREE
+ * 若n<=c, 事件依次位于下标0~n-1; 否则最旧的事件位于下标n%c, 依次回绕.
+ * heap_Calloc记录为一次分配(大小为nmemb*size); heap_Realloc成功时记录为
+ * 释放原内存与分配新内存两个事件, 失败时仅记录一次失败的分配;
+ * 导出的缓冲区可由主机工具host/heap_trace解码, 并在不同算法上回放比较
+ */
+typedef struct heap_trace_event HeapTraceEvent_t;
+struct heap_trace_event
+{
+    void   *caller;                 /*调用者地址        */
+    void   *ptr;                    /*内存地址          */
+    size_t  size;                   /*请求大小或释放标志*/
+};
+/*释放事件标志*/
+#define HEAP_TRACE_FREE             ( ((size_t)1) << (8*sizeof(size_t)-1) )
+
+/*Heap内存区域属性*/
+#define HEAP_REGION_ATTR_FAST       ( 0x01 )    /*高速内存, 如内部SRAM      */
+#define HEAP_REGION_ATTR_DMA        ( 0x02 )    /*DMA可访问                 */
+#define HEAP_REGION_ATTR_BULK       ( 0x04 )    /*大容量内存, 如FSMC外部SRAM*/
+/*
+ * Heap分配位置提示, 由HEAP_REGION_ATTR_xxx组合而成,
+ * 优先在具有全部指定属性的区域中分配, 失败后再按区域顺序在其余区域中分配;
+ * 附加HEAP_HINT_STRICT时, 仅在具有全部指定属性的区域中分配
+ */
+#define HEAP_HINT_ANY               ( 0x00 )
+#define HEAP_HINT_STRICT            ( 0x80 )
+
+/*Heap内存区域描述类型*/
+typedef struct heap_region HeapRegion_t;
+struct heap_region
+{
+    uint8_t    *startAddr;          /*区域起始地址*/
+    size_t      totalSize;          /*区域总大小  */
+    uint8_t     attr;               /*区域属性    */
 };
 
 /* 操作函数 ------------------------------------------------------------------*/
 /*Heap设备操作函数*/
 HeapDev_t *heap_Create( uint8_t *startAddr, size_t totalSize );
+HeapDev_t *heap_CreateEx( uint8_t *startAddr, size_t totalSize, HeapAlgo_t algo );
+HeapDev_t *heap_CreateRegions( const HeapRegion_t *regions, size_t count, HeapAlgo_t algo );
 void heap_GetInfo( HeapDev_t *heap, HeapInfo_t *info );
+size_t heap_GetRegionCount( HeapDev_t *heap );
+bool heap_GetRegionInfo( HeapDev_t *heap, size_t index, HeapInfo_t *info );
+void heap_SetIsrSafe( HeapDev_t *heap, bool isrSafe );
 /*动态内存分配函数*/
 void *heap_Malloc( HeapDev_t *heap, size_t size );
+void *heap_MallocHint( HeapDev_t *heap, size_t size, uint8_t hint );
 void *heap_Calloc( HeapDev_t *heap, size_t nmemb, size_t size );
 void *heap_Realloc( HeapDev_t *heap, void *ptr, size_t size );
 void heap_Free( HeapDev_t *heap, void *ptr );
+/*对齐内存分配函数*/
+void *heap_MallocAligned( HeapDev_t *heap, size_t size, size_t alignment );
+void heap_FreeAligned( HeapDev_t *heap, void *ptr );
+/*碎片统计函数*/
+void heap_GetFragmentation( HeapDev_t *heap, HeapFragInfo_t *info );
+#if HEAP_USE_TRACE
+/*分配追踪函数*/
+void heap_TraceStart( HeapDev_t *heap, HeapTraceEvent_t *buffer, size_t count );
+void heap_TraceStop( HeapDev_t *heap );
+size_t heap_TraceGetCount( HeapDev_t *heap );
+#endif
 
 #endif  /* __CPULIB_HEAP_H */
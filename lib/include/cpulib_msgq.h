@@ -0,0 +1,57 @@
+/*******************************************************************************
+* 文 件 名: cpulib_msgq.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 变长消息队列, 建立在SPSC FIFO之上
+*******************************************************************************/
+
+#ifndef __CPULIB_MSGQ_H
+#define __CPULIB_MSGQ_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpulib_def.h"
+#include "cpulib_fifo.h"
+
+/* 数据结构 ------------------------------------------------------------------*/
+/*
+ * 消息队列以长度前缀(size_t)连续保存消息, 消息按sizeof(size_t)对齐且从不跨越
+ * 存储区末尾, 末尾空间不足时插入填充记录后从存储区起始位置保存;
+ * 单生产者单消费者, 生产者与消费者分别位于中断函数和线程函数时无需临界区保护
+ */
+typedef void MsgQueue_t;
+
+/*
+ * 消息队列结构体类型
+ * size: 存储区字节数, 必须为2的幂并且不小于4*sizeof(size_t)
+ */
+#define STRUCT_MSGQ(size)       STRUCT_SPSC_FIFO(uint8_t, size)
+
+/*
+ * 获取单条消息的最大长度, 长度前缀加对齐后的消息内容不超过存储区的一半,
+ * 保证消息队列排空后无论写索引位于何处, 末尾填充后都能容纳该消息
+ * size:   存储区字节数
+ * return: 最大消息长度
+ */
+#define MSGQ_MAX_LEN(size)      ( (size_t)(size)/2 - sizeof(size_t) )
+
+/*
+ * 初始化消息队列
+ * pmsgq: 消息队列结构体指针, STRUCT_MSGQ(size)的指针类型
+ */
+#define INIT_MSGQ(pmsgq)        INIT_SPSC_FIFO(pmsgq)
+
+/* 操作函数 ------------------------------------------------------------------*/
+/*生产者操作函数*/
+void *msgq_Reserve( MsgQueue_t *pmsgq, size_t len );
+void msgq_Commit( MsgQueue_t *pmsgq, size_t len );
+bool msgq_Send( MsgQueue_t *pmsgq, const void *msg, size_t len );
+/*消费者操作函数*/
+void *msgq_Peek( MsgQueue_t *pmsgq, size_t *len );
+void msgq_Consume( MsgQueue_t *pmsgq );
+size_t msgq_Receive( MsgQueue_t *pmsgq, void *buffer, size_t size );
+
+bool msgq_IsEmpty( MsgQueue_t *pmsgq );
+void msgq_Reset( MsgQueue_t *pmsgq );
+
+#endif  /* __CPULIB_MSGQ_H */
@@ -0,0 +1,29 @@
+/*******************************************************************************
+* 文 件 名: cpulib_pool.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 固定大小内存块池
+*******************************************************************************/
+
+#ifndef __CPULIB_POOL_H
+#define __CPULIB_POOL_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpulib_def.h"
+#include "cpulib_heap.h"
+
+/* 数据类型 ------------------------------------------------------------------*/
+/*内存池设备类型*/
+typedef void PoolDev_t;
+
+/* 操作函数 ------------------------------------------------------------------*/
+/*内存池设备操作函数*/
+PoolDev_t *pool_Create( uint8_t *startAddr, size_t totalSize, size_t blockSize, bool isrSafe );
+void pool_GetInfo( PoolDev_t *pool, HeapInfo_t *info );
+size_t pool_GetBlockSize( PoolDev_t *pool );
+/*内存块分配函数*/
+void *pool_Alloc( PoolDev_t *pool );
+void pool_Free( PoolDev_t *pool, void *ptr );
+
+#endif  /* __CPULIB_POOL_H */
@@ -0,0 +1,50 @@
+/*******************************************************************************
+* 文 件 名: cpulib_slab.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: Slab对象缓存, 建立在Heap设备之上
+*******************************************************************************/
+
+#ifndef __CPULIB_SLAB_H
+#define __CPULIB_SLAB_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpulib_def.h"
+#include "cpulib_heap.h"
+
+/* Slab参数 ------------------------------------------------------------------*/
+/*
+ * SLAB_DEFAULT_OBJECTS: slab_Create未指定slab大小时, 每个slab至少容纳的对象数量,
+ *                       可在cpu_config.h中重新定义
+ */
+#ifndef SLAB_DEFAULT_OBJECTS
+    #define SLAB_DEFAULT_OBJECTS    ( 8 )
+#endif
+
+/* 数据类型 ------------------------------------------------------------------*/
+/*Slab对象缓存设备类型*/
+typedef void SlabDev_t;
+/*对象构造函数类型, 每次分配对象时调用*/
+typedef void (*SlabCtor_t)(void *obj);
+
+/* 操作函数 ------------------------------------------------------------------*/
+/*
+ * 对象缓存及全部对象缓存链表均不进行临界区保护, 禁止在中断函数中调用;
+ * 多个线程使用对象缓存时(包括slab_ShrinkAll及slab_Alloc内存不足时的回收,
+ * 二者会访问其他对象缓存), 由调用者负责互斥
+ */
+/*Slab对象缓存设备操作函数*/
+SlabDev_t *slab_Create( HeapDev_t *heap, const char *name, size_t objSize, size_t slabSize, SlabCtor_t ctor );
+void slab_Destroy( SlabDev_t *cache );
+void slab_GetInfo( SlabDev_t *cache, HeapInfo_t *info );
+const char *slab_GetName( SlabDev_t *cache );
+size_t slab_GetObjectSize( SlabDev_t *cache );
+/*对象分配函数*/
+void *slab_Alloc( SlabDev_t *cache );
+void slab_Free( SlabDev_t *cache, void *ptr );
+/*内存回收函数*/
+size_t slab_Shrink( SlabDev_t *cache );
+size_t slab_ShrinkAll( void );
+
+#endif  /* __CPULIB_SLAB_H */
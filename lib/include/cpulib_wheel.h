@@ -0,0 +1,71 @@
+/*******************************************************************************
+* 文 件 名: cpulib_wheel.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: 分层时间轮, 用于节拍定时器管理
+*******************************************************************************/
+
+#ifndef __CPULIB_WHEEL_H
+#define __CPULIB_WHEEL_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpulib_def.h"
+#include "cpulib_list.h"
+
+/* 时间轮参数 ----------------------------------------------------------------*/
+/*
+ * WHEEL_SLOT_BITS: 每层槽数的位数, 每层包含2^WHEEL_SLOT_BITS个槽
+ * WHEEL_LEVELS:    时间轮层数, 直接覆盖2^(WHEEL_SLOT_BITS*WHEEL_LEVELS)个节拍,
+ *                  更远的定时器暂存于最高层, 级联时重新放置;
+ *                  WHEEL_SLOT_BITS*WHEEL_LEVELS必须小于tick_t的位数
+ * 均可在cpu_config.h中重新定义
+ */
+#ifndef WHEEL_SLOT_BITS
+    #define WHEEL_SLOT_BITS         ( 4 )
+#endif
+
+#ifndef WHEEL_LEVELS
+    #define WHEEL_LEVELS            ( 3 )
+#endif
+
+#define WHEEL_SLOTS                 ( 1 << WHEEL_SLOT_BITS )
+
+/* 数据结构 ------------------------------------------------------------------*/
+/*时间轮定时器类型*/
+typedef struct wheel_timer WheelTimer_t;
+/*定时器到期处理函数类型, 在wheel_Tick()中调用*/
+typedef void (*WheelHandler_t) (WheelTimer_t *timer);
+struct wheel_timer
+{
+    tick_t              expire;     /*到期节拍        */
+    tick_t              period;     /*重装周期        */
+    WheelHandler_t      handler;    /*到期处理函数    */
+    ListNode_t          node;       /*时间轮槽链表结点*/
+};
+
+/*
+ * 时间轮, 第0层每个槽对应一个节拍, 第n层每个槽对应2^(WHEEL_SLOT_BITS*n)个节拍;
+ * 每个节拍只处理第0层当前槽中到期的定时器, 低层转满一圈时将高层对应槽中的
+ * 定时器级联到低层, 每个定时器最多被级联WHEEL_LEVELS-1次
+ */
+typedef struct time_wheel TimeWheel_t;
+struct time_wheel
+{
+    tick_t              now;                                /*已处理的节拍数*/
+    ListHead_t          slot[WHEEL_LEVELS][WHEEL_SLOTS];    /*各层时间槽    */
+};
+
+/* 操作函数 ------------------------------------------------------------------*/
+/*时间轮操作函数不进行临界区保护, 由调用者负责*/
+void wheel_Init( TimeWheel_t *wheel );
+void wheel_TimerInit( WheelTimer_t *timer, WheelHandler_t handler );
+void wheel_Add( TimeWheel_t *wheel, WheelTimer_t *timer, tick_t delay, tick_t period );
+bool wheel_Del( WheelTimer_t *timer );
+bool wheel_IsActive( WheelTimer_t *timer );
+void wheel_Tick( TimeWheel_t *wheel );
+/*低功耗空闲(节拍抑制)支持函数*/
+tick_t wheel_NextExpiry( TimeWheel_t *wheel );
+void wheel_Skip( TimeWheel_t *wheel, tick_t n );
+
+#endif  /* __CPULIB_WHEEL_H */
@@ -24,6 +24,7 @@
 /* CPU宏定义 -----------------------------------------------------------------*/
 #define CPU_TICK_PERIOD_IS_1MS
 /* #define CPU_USE_16BIT_TICK */
+/* #define CPU_USE_TICKLESS_IDLE */                 /* 低功耗空闲时抑制节拍   */
 /* #define CPU_INTERRUPT_NOT_NESTING */
 
 /* OS宏定义 ------------------------------------------------------------------*/
@@ -8,14 +8,67 @@
 *******************************************************************************/
 
 #include "cpu_tick.h"
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+#ifdef CPU_USE_TICKLESS_IDLE
+/*一个节拍的SysTick计数值*/
+#define __TICK_RELOAD               ( CPU_TIMER_HZ/CPU_TICK_HZ )
+/*24位SysTick单次最多覆盖的节拍数*/
+#define __TICK_IDLE_MAX             ( (tick_t)(SysTick_LOAD_RELOAD_Msk/__TICK_RELOAD) )
+#endif
+
 /*******************************************************************************
 
                                     全局变量
 
 *******************************************************************************/
-static ListHead_t cpuTickIRQList;
+static TimeWheel_t cpuTickWheel;
+static ListHead_t cpuTickDeferList;
+static volatile systime_t cpuTickCount = 0;
 static uint32_t fac_us = 0;
 
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/**
+ * 时间轮定时器到期处理函数, 调用对应的节拍中断服务函数
+ *
+ * @param timer: 到期的时间轮定时器指针
+ */
+static void prvTickIRQDispatch(WheelTimer_t *timer)
+{
+TickIRQ_t *irq = container_of(timer, TickIRQ_t, timer);
+cpu_t cpu_sr;
+
+    if ( !irq->deferred )
+    {
+        (irq->isr)();
+        return;
+    }
+    cpu_sr = CPU_EnterCriticalFromISR();
+    {
+        if ( list_IsEmpty(&irq->deferNode) )
+        {
+            list_AddTail(&cpuTickDeferList, &irq->deferNode);
+#ifndef CPU_USE_OS_FREERTOS
+            /*触发PendSV, 在所有中断处理完毕后执行*/
+            SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+#endif
+        }
+        else
+        {
+            /*上一次到期尚未执行, 合并为一次执行并记为溢出*/
+            irq->overrun++;
+        }
+    }
+    CPU_ExitCriticalFromISR(cpu_sr);
+}
+
 /*******************************************************************************
 
                                     节拍函数
@@ -27,8 +80,12 @@ void cpu_TickInit(void)
 #ifdef CPU_TICK_PERIOD_IS_1MS
     CPU_Assert(CPU_TICK_HZ == 1000);
 #endif
-    list_Init(&cpuTickIRQList);
+    CPU_Assert(0 == 1000000%CPU_TICK_HZ);
+    wheel_Init(&cpuTickWheel);
+    list_Init(&cpuTickDeferList);
     fac_us = CPU_TIMER_HZ/1000000;
+    /*PendSV用于执行延迟节拍中断请求, 设置为最低优先级*/
+    cpu_NVIC_SetPriority(PendSV_IRQn, 15, 0);
     /*初始化SysTick*/
     SysTick_Config(CPU_TIMER_HZ/CPU_TICK_HZ);
 }
@@ -44,56 +101,337 @@ void cpu_TickInit(void)
  */
 void cpu_TickIRQRegister(TickIRQ_t *irq, tick_t period, TickIRQHandler_t isr)
 {
-cpu_t cpu_sr;
-
     /*参数检验*/
     CPU_Assert(0 != period);
     CPU_Assert(0 != isr);
     /*注册节拍中断*/
-    list_Init(&irq->node);
-    irq->period = period;
-    irq->count  = period-1;
-    irq->isr    = isr;
+    cpu_TickIRQInit(irq, isr);
+    cpu_TickIRQStart(irq, period, period);
+}
+
+/**
+ * 初始化节拍中断请求, 初始化后处于停止状态
+ *
+ * @param irq: 节拍中断请求的结构体指针, 必须未启动
+ *
+ * @param isr: 节拍中断请求的处理函数指针
+ */
+void cpu_TickIRQInit(TickIRQ_t *irq, TickIRQHandler_t isr)
+{
+    CPU_Assert(0 != isr);
+    wheel_TimerInit(&irq->timer, prvTickIRQDispatch);
+    list_Init(&irq->deferNode);
+    irq->isr      = isr;
+    irq->deferred = false;
+    irq->overrun  = 0;
+}
+
+/**
+ * 启动节拍中断请求, 已启动时按新的参数重新启动, O(1)
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @param delay: 首次产生节拍中断前的节拍数, 不能为0
+ *
+ * @param period: 之后产生节拍中断的周期, 为0时为单次节拍中断请求
+ */
+void cpu_TickIRQStart(TickIRQ_t *irq, tick_t delay, tick_t period)
+{
+cpu_t cpu_sr;
+
+    CPU_Assert(0 != delay);
+    cpu_sr = CPU_EnterCritical();
+    {
+        wheel_Del(&irq->timer);
+        wheel_Add(&cpuTickWheel, &irq->timer, delay, period);
+    }
+    CPU_ExitCritical(cpu_sr);
+}
+
+/**
+ * 停止节拍中断请求, O(1), 可在节拍中断服务函数中调用
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @return: 返回布尔值, true表示停止前处于启动状态或有尚未执行的延迟节拍中断,
+ *          false表示已停止或单次节拍中断请求已经执行
+ */
+bool cpu_TickIRQStop(TickIRQ_t *irq)
+{
+bool ret;
+cpu_t cpu_sr;
+
     cpu_sr = CPU_EnterCritical();
     {
-        list_Add(&cpuTickIRQList, &irq->node);
+        ret = wheel_Del(&irq->timer);
+        /*同时取消尚未执行的延迟节拍中断*/
+        if ( !list_IsEmpty(&irq->deferNode) )
+        {
+            list_Del(&irq->deferNode);
+            ret = true;
+        }
     }
     CPU_ExitCritical(cpu_sr);
+    return (ret);
+}
+
+/**
+ * 修改节拍中断请求的周期, 已安排的下一次节拍中断不变, 之后按新的周期产生
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @param period: 新的周期, 为0时下一次节拍中断后停止
+ *
+ * @note: 需要立即以新的周期重新计时时, 使用cpu_TickIRQStart(irq, period, period)
+ */
+void cpu_TickIRQSetPeriod(TickIRQ_t *irq, tick_t period)
+{
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        irq->timer.period = period;
+    }
+    CPU_ExitCritical(cpu_sr);
+}
+
+/**
+ * 判断节拍中断请求是否处于启动状态
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @return: 返回布尔值, true表示处于启动状态
+ */
+bool cpu_TickIRQIsActive(TickIRQ_t *irq)
+{
+    return ( wheel_IsActive(&irq->timer) );
+}
+
+/**
+ * 设置节拍中断请求的执行方式
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @param deferred: true表示到期后由cpu_TickDeferHandler()在PendSV中断函数中执行,
+ *                  节拍中断函数只将其加入延迟执行链表; false表示在节拍中断函数中执行
+ */
+void cpu_TickIRQSetDeferred(TickIRQ_t *irq, bool deferred)
+{
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        irq->deferred = deferred;
+    }
+    CPU_ExitCritical(cpu_sr);
+}
+
+/**
+ * 获取延迟节拍中断请求的溢出次数
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @return: 返回到期时上一次到期尚未执行, 被合并执行的次数
+ */
+size_t cpu_TickIRQGetOverrun(TickIRQ_t *irq)
+{
+    return (irq->overrun);
 }
 
 /**
  * (总)节拍中断处理函数
  *
- * @note: 以CPU_TICK_HZ的频率, 在CPU节拍中断函数中调用
+ * @note: 以CPU_TICK_HZ的频率, 在CPU节拍中断函数中调用,
+ *        只处理当前节拍到期的节拍中断请求
  */
 void cpu_TickHandler(void)
 {
-ListNode_t *pos;
+cpu_t cpu_sr;
+
+    /*读取CTRL同时清除COUNTFLAG, 该节拍已被cpu_GetTimeUs()计入时不再重复计数*/
+    cpu_sr = CPU_EnterCriticalFromISR();
+    {
+        if ( 0 != (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) )
+        {
+            cpuTickCount++;
+        }
+    }
+    CPU_ExitCriticalFromISR(cpu_sr);
+    wheel_Tick(&cpuTickWheel);
+}
+
+/**
+ * 延迟节拍中断处理函数, 依次执行已到期的延迟节拍中断请求
+ *
+ * @note: 在PendSV中断函数中调用, PendSV为最低优先级, 由节拍中断函数触发;
+ *        使用FreeRTOS时PendSV由内核占用, 需在任务中调用本函数
+ */
+void cpu_TickDeferHandler(void)
+{
+ListNode_t *pNode;
 TickIRQ_t  *irq;
+cpu_t cpu_sr;
 
-    list_for_each(pos, &cpuTickIRQList)
+    for ( ;; )
     {
-        irq = list_entry(pos, TickIRQ_t, node);
-        if (irq->period > 0)
+        irq = NULL;
+        cpu_sr = CPU_EnterCritical();
         {
-            if (irq->count > 0)
-            {
-                irq->count--;
-            }
-            else
+            if ( !list_IsEmpty(&cpuTickDeferList) )
             {
-                irq->count = irq->period - 1;
-                (irq->isr)();
+                pNode = cpuTickDeferList.next;
+                list_Del(pNode);
+                irq = list_entry(pNode, TickIRQ_t, deferNode);
             }
         }
+        CPU_ExitCritical(cpu_sr);
+        if ( NULL == irq )
+        {
+            break;
+        }
+        (irq->isr)();
+    }
+}
+
+#ifdef CPU_USE_TICKLESS_IDLE
+/**
+ * 低功耗空闲, 在主程序空闲循环中调用
+ *
+ * @note: 按下一个需要处理的节拍重新设置SysTick周期, 在WFI中连续睡眠多个节拍,
+ *        唤醒后修正SysTick并跳过已经过去的节拍; WFI在关闭中断时执行,
+ *        唤醒中断在修正完成并退出临界区后才被响应
+ *
+ * @return: 返回跳过的节拍数, 这些节拍不会产生节拍中断,
+ *          节拍中断函数中的其他节拍使用者(如调度器)需要据此补偿
+ */
+tick_t cpu_TickIdle(void)
+{
+uint32_t ctrl, load, elapsed;
+tick_t idle, skip;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    /*有尚未执行的延迟节拍中断时不进入低功耗空闲*/
+    if ( !list_IsEmpty(&cpuTickDeferList) )
+    {
+        CPU_ExitCritical(cpu_sr);
+        return (0);
+    }
+    idle = wheel_NextExpiry(&cpuTickWheel);
+    if ( idle > __TICK_IDLE_MAX )
+    {
+        idle = __TICK_IDLE_MAX;
+    }
+    if ( idle < 2 )
+    {
+        CPU_WFI();
+        CPU_ExitCritical(cpu_sr);
+        return (0);
+    }
+    /*停止SysTick, 节拍中断已挂起时放弃本次低功耗空闲*/
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+    if ( 0 != (ctrl & SysTick_CTRL_COUNTFLAG_Msk) )
+    {
+        /*读取CTRL已清除COUNTFLAG, 尚未计数的节拍在此计入*/
+        cpuTickCount++;
+    }
+    if ( 0 != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) )
+    {
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        CPU_ExitCritical(cpu_sr);
+        return (0);
+    }
+    /*当前节拍的剩余计数加上idle-1个完整节拍*/
+    load = SysTick->VAL + __TICK_RELOAD*(idle - 1) - 1;
+    SysTick->LOAD = load;
+    SysTick->VAL  = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    CPU_WFI();
+    /*停止SysTick, 读取CTRL同时清除COUNTFLAG*/
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+    if ( 0 != (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) )
+    {
+        /*睡眠到预定节拍, 节拍中断已挂起, 退出临界区后处理最后一个节拍*/
+        elapsed = load - SysTick->VAL;
+        SysTick->LOAD = (elapsed < __TICK_RELOAD - 1) ? (__TICK_RELOAD - 1 - elapsed) : (__TICK_RELOAD - 1);
+        skip = idle - 1;
+        /*读取CTRL已清除COUNTFLAG, 最后一个节拍在此计入*/
+        cpuTickCount++;
     }
+    else
+    {
+        /*被其他中断提前唤醒, 按已经过去的计数修正节拍*/
+        elapsed = __TICK_RELOAD*idle - SysTick->VAL;
+        skip    = (tick_t)(elapsed/__TICK_RELOAD);
+        SysTick->LOAD = (skip + 1)*__TICK_RELOAD - elapsed - 1;
+    }
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    wheel_Skip(&cpuTickWheel, skip);
+    cpuTickCount += skip;
+    /*从下一个节拍开始恢复正常周期*/
+    SysTick->LOAD = __TICK_RELOAD - 1;
+    CPU_ExitCritical(cpu_sr);
+    return (skip);
 }
+#endif  /* CPU_USE_TICKLESS_IDLE */
 
 /*******************************************************************************
 
                                     时间管理
 
 *******************************************************************************/
+/**
+ * 获取CPU节拍计数
+ *
+ * @return: 返回cpu_TickInit()之后经过的节拍数, 单调递增
+ */
+systime_t cpu_GetTicks(void)
+{
+systime_t ticks;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        ticks = cpuTickCount;
+    }
+    CPU_ExitCritical(cpu_sr);
+    return (ticks);
+}
+
+/**
+ * 获取微秒级单调时间, 由节拍计数与SysTick当前计数合成
+ *
+ * @return: 返回cpu_TickInit()之后经过的时间(us), 单调递增
+ */
+systime_t cpu_GetTimeUs(void)
+{
+systime_t ticks;
+uint32_t load, val;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        ticks = cpuTickCount;
+        load  = SysTick->LOAD;
+        val   = SysTick->VAL;
+        /*
+         * COUNTFLAG置位表示SysTick已回绕但该节拍尚未计数(节拍中断挂起, 或已进入
+         * 节拍中断但被更高优先级中断抢占), 在此计入并重新读取计数值;
+         * 读取CTRL同时清除COUNTFLAG, 节拍中断函数不会重复计数
+         */
+        if ( 0 != (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) )
+        {
+            cpuTickCount++;
+            ticks = cpuTickCount;
+            val   = SysTick->VAL;
+        }
+    }
+    CPU_ExitCritical(cpu_sr);
+    return ( ticks*(1000000/CPU_TICK_HZ) + (load - val)/fac_us );
+}
+
 /**
  * 微秒级延时函数
  *
@@ -0,0 +1,171 @@
+/*******************************************************************************
+* MCU型 号: STM32F1XX
+* 文 件 名: cpu_usart.c
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: USART接收, DMA循环模式写入SPSC FIFO
+*******************************************************************************/
+
+#include "cpu_usart.h"
+
+static void prvUsartDmaRxPublish(UsartDmaRx_t *rx);
+/*******************************************************************************
+
+                                    接口函数
+
+*******************************************************************************/
+/**
+ * 初始化USART DMA接收
+ *
+ * @param rx: USART DMA接收结构体指针
+ *
+ * @param usart: USART外设, 须已完成GPIO和波特率等配置
+ *
+ * @param channel: USART_RX请求对应的DMA通道, 如USART1为DMA1_Channel5
+ *
+ * @param dmaITGL: DMA通道全局中断标志, 如DMA1_IT_GL5
+ *
+ * @param fifo: 接收FIFO, 元素类型为uint8_t的SPSC FIFO, DMA直接写入其存储区
+ *
+ * @param handler: 新数据通知函数, 可为NULL
+ *
+ * @note: DMA时钟及USART, DMA通道的NVIC中断由调用者使能;
+ *        USART中断函数中调用cpu_UsartDmaRxUsartIRQHandler(),
+ *        DMA通道中断函数中调用cpu_UsartDmaRxDmaIRQHandler();
+ *        DMA写索引由通道剩余计数换算, 总线空闲, 半满及全满时发布到FIFO,
+ *        消费者使用fifo_SpscOut()或fifo_SpscOutPeekLinear()读取数据;
+ *        消费者未及时读取导致数据被覆盖时, 读位置不变, 随后读到的是
+ *        DMA最新写入的数据, 中间的旧数据被丢弃, 见cpu_UsartDmaRxGetOverrun()
+ */
+void cpu_UsartDmaRxInit(UsartDmaRx_t *rx, USART_TypeDef *usart, DMA_Channel_TypeDef *channel,
+                        uint32_t dmaITGL, SPSC_FIFO_t *fifo, UsartRxHandler_t handler)
+{
+DMA_InitTypeDef DMA_InitStructure;
+
+    /*参数检验*/
+    CPU_Assert(NULL != rx);
+    CPU_Assert(1 == ((struct __spsc_fifo *)fifo)->esize);
+    /*初始化接收结构体*/
+    rx->usart   = usart;
+    rx->channel = channel;
+    rx->dmaITGL = dmaITGL;
+    rx->fifo    = (struct __spsc_fifo *)fifo;
+    rx->handler = handler;
+    rx->overrun = 0;
+    fifo_SpscReset(fifo);
+    /*DMA循环模式, 外设到存储区*/
+    DMA_DeInit(channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&usart->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t)rx->fifo->data;
+    DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize         = rx->fifo->mask + 1;
+    DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode               = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority           = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M                = DMA_M2M_Disable;
+    DMA_Init(channel, &DMA_InitStructure);
+    DMA_ClearITPendingBit(dmaITGL);
+    DMA_ITConfig(channel, DMA_IT_HT|DMA_IT_TC, ENABLE);
+    /*使能总线空闲中断及DMA接收请求*/
+    USART_ITConfig(usart, USART_IT_IDLE, ENABLE);
+    USART_DMACmd(usart, USART_DMAReq_Rx, ENABLE);
+    DMA_Cmd(channel, ENABLE);
+}
+
+/**
+ * USART中断处理, 总线空闲时发布已接收的数据
+ *
+ * @param rx: USART DMA接收结构体指针
+ *
+ * @note: 在USART中断函数中调用
+ */
+void cpu_UsartDmaRxUsartIRQHandler(UsartDmaRx_t *rx)
+{
+    if ( RESET != USART_GetITStatus(rx->usart, USART_IT_IDLE) )
+    {
+        /*先读SR再读DR, 清除IDLE标志*/
+        (void)rx->usart->DR;
+        prvUsartDmaRxPublish(rx);
+    }
+}
+
+/**
+ * DMA通道中断处理, 半满及全满时发布已接收的数据
+ *
+ * @param rx: USART DMA接收结构体指针
+ *
+ * @note: 在DMA通道中断函数中调用
+ */
+void cpu_UsartDmaRxDmaIRQHandler(UsartDmaRx_t *rx)
+{
+    DMA_ClearITPendingBit(rx->dmaITGL);
+    prvUsartDmaRxPublish(rx);
+}
+
+/**
+ * 获取数据被覆盖的次数
+ *
+ * @param rx: USART DMA接收结构体指针
+ *
+ * @return: 返回消费者未及时读取, 导致未读数据被DMA覆盖的次数
+ *
+ * @note: 发生覆盖后FIFO读位置不变, 消费者接着读到的是DMA最新一圈写入的
+ *        数据, 与此前已读取的数据不连续; 按帧解析的消费者可在每次读取前
+ *        比较本函数返回值, 变化时丢弃未完成的帧并重新同步
+ */
+size_t cpu_UsartDmaRxGetOverrun(UsartDmaRx_t *rx)
+{
+    return (rx->overrun);
+}
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/*
+ * 由DMA剩余计数换算写索引并发布到FIFO, 仅在中断函数中调用;
+ * 半满与全满中断保证两次发布之间DMA前进不超过一圈;
+ * 始终保持(in & mask) == DMA写入位置, 后续增量才能从正确位置计算
+ */
+static void prvUsartDmaRxPublish(UsartDmaRx_t *rx)
+{
+struct __spsc_fifo *pFIFO = rx->fifo;
+size_t size = pFIFO->mask + 1;
+size_t pos, in, delta;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCriticalFromISR();
+    {
+        pos   = (size - rx->channel->CNDTR) & pFIFO->mask;
+        in    = pFIFO->in;
+        delta = (pos - in) & pFIFO->mask;
+        if ( 0 != delta )
+        {
+            in += delta;
+            if ( (in - pFIFO->out) > size )
+            {
+                /*
+                 * 未读数据已被覆盖, 取不超过out+size且与DMA写入位置同余的
+                 * 最大写索引; out不变, 消费者接着读取的[out, pos)是DMA最新
+                 * 一圈写入的数据, 其后尚未被覆盖的旧数据[pos, out)被丢弃,
+                 * 数据流在此处不连续, 由overrun计数指示
+                 */
+                rx->overrun++;
+                in = pFIFO->out + size - ((pFIFO->out - pos) & pFIFO->mask);
+            }
+            /*DMA写入先于写索引更新*/
+            CPU_DMB();
+            pFIFO->in = in;
+        }
+    }
+    CPU_ExitCriticalFromISR(cpu_sr);
+    if ( (0 != delta) && (NULL != rx->handler) )
+    {
+        (rx->handler)(rx);
+    }
+}
@@ -125,6 +125,9 @@ void DebugMon_Handler(void)
   */
 void PendSV_Handler(void)
 {
+#ifndef CPU_USE_OS_FREERTOS
+    cpu_TickDeferHandler();
+#endif
 }
 
 #ifdef CPU_USE_OS_SCHEDULER
@@ -97,6 +97,16 @@ typedef base_t          cpu_t;
 /* 底层操作宏 ----------------------------------------------------------------*/
 #define CPU_NOP()               __NOP()
 #define CPU_RESET()             NVIC_SystemReset()
+#define CPU_CLZ(x)              __CLZ(x)
+/*数据内存屏障, 保证屏障前的内存访问先于屏障后的内存访问完成*/
+#define CPU_DMB()               __DMB()
+/*进入睡眠, 直到下一个中断到来*/
+#define CPU_WFI()               __WFI()
+#if   defined ( __CC_ARM )
+    #define CPU_RETURN_ADDRESS()    ( (void *)__return_address() )
+#elif defined ( __GNUC__ )
+    #define CPU_RETURN_ADDRESS()    __builtin_return_address(0)
+#endif
 
 /* CPU中断管理 ---------------------------------------------------------------*/
 /*判断CPU是否处于处理模式*/
@@ -118,6 +128,27 @@ STATIC_INLINE void cpu_irq_restore(cpu_t cpu_sr)
     __set_PRIMASK(cpu_sr);
 }
 
+/* CPU原子操作 ---------------------------------------------------------------*/
+/*
+ * 原子比较交换, 使用LDREX/STREX实现, 不关闭中断
+ * ptr:      目标地址
+ * expected: 期望值
+ * desired:  新值
+ * return:   若*ptr等于expected, 写入desired并返回true, 否则返回false
+ */
+STATIC_INLINE bool cpu_AtomicCAS(volatile size_t *ptr, size_t expected, size_t desired)
+{
+    do
+    {
+        if ( __LDREXW((volatile uint32_t *)ptr) != expected )
+        {
+            __CLREX();
+            return (false);
+        }
+    } while ( 0 != __STREXW(desired, (volatile uint32_t *)ptr) );
+    return (true);
+}
+
 void cpu_NVIC_SetPriorityGrouping(uint32_t PriorityGroup);
 void cpu_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
 void cpu_NVIC_EnableIRQ(IRQn_Type IRQn);
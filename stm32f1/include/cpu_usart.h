@@ -0,0 +1,39 @@
+/*******************************************************************************
+* MCU型 号: STM32F1XX
+* 文 件 名: cpu_usart.h
+* 创 建 者: Keda Huang
+* 版    本: V1.0
+* 创建日期: 2026-10-17
+* 文件说明: USART接收, DMA循环模式写入SPSC FIFO
+*******************************************************************************/
+
+#ifndef __CPU_USART_H
+#define __CPU_USART_H
+
+/* 头文件 --------------------------------------------------------------------*/
+#include "cpu_port.h"
+#include "cpulib_fifo.h"
+
+/* 数据结构 ------------------------------------------------------------------*/
+/*USART DMA接收结构体类型*/
+typedef struct usart_dma_rx UsartDmaRx_t;
+/*新数据通知函数类型, 在中断函数中调用*/
+typedef void (*UsartRxHandler_t) (UsartDmaRx_t *rx);
+struct usart_dma_rx
+{
+    USART_TypeDef          *usart;      /*USART外设           */
+    DMA_Channel_TypeDef    *channel;    /*USART_RX对应DMA通道 */
+    uint32_t                dmaITGL;    /*DMA通道全局中断标志 */
+    struct __spsc_fifo     *fifo;       /*接收FIFO            */
+    UsartRxHandler_t        handler;    /*新数据通知函数      */
+    volatile size_t         overrun;    /*数据被覆盖的次数, 覆盖后数据流不连续*/
+};
+
+/* 接口函数 ------------------------------------------------------------------*/
+void cpu_UsartDmaRxInit(UsartDmaRx_t *rx, USART_TypeDef *usart, DMA_Channel_TypeDef *channel,
+                        uint32_t dmaITGL, SPSC_FIFO_t *fifo, UsartRxHandler_t handler);
+void cpu_UsartDmaRxUsartIRQHandler(UsartDmaRx_t *rx);
+void cpu_UsartDmaRxDmaIRQHandler(UsartDmaRx_t *rx);
+size_t cpu_UsartDmaRxGetOverrun(UsartDmaRx_t *rx);
+
+#endif  /* __CPU_USART_H */
@@ -24,8 +24,17 @@
 /* CPU宏定义 -----------------------------------------------------------------*/
 /* #define CPU_TICK_PERIOD_IS_1MS */
 /* #define CPU_USE_16BIT_TICK */
+/*
+ * 低功耗空闲时抑制节拍; Timer4为8位计数器, 要求CPU_TIMER_HZ/CPU_TICK_HZ不超过256,
+ * 如16MHz HSE时CPU_TICK_HZ须不低于1000, 否则编译报错
+ */
+/* #define CPU_USE_TICKLESS_IDLE */                 /* 低功耗空闲时抑制节拍   */
 #define CPU_INTERRUPT_NOT_NESTING                   /* STM8S中断优先级设置为3 */
 
+/* 节拍时间轮配置 ------------------------------------------------------------*/
+#define WHEEL_SLOT_BITS     ( 3 )                   /* 时间轮每层槽数位数     */
+#define WHEEL_LEVELS        ( 3 )                   /* 时间轮层数             */
+
 /* OS宏定义 ------------------------------------------------------------------*/
 #define CPU_USE_OS_SCHEDULER
 /* #define CPU_USE_OS_FREERTOS */
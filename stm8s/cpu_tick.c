@@ -8,13 +8,92 @@
 *******************************************************************************/
 
 #include "cpu_tick.h"
+/*******************************************************************************
+
+                                     宏定义
+
+*******************************************************************************/
+#ifdef CPU_USE_TICKLESS_IDLE
+/*一个节拍的Timer4计数值(64分频)*/
+#define __TICK_RELOAD               ( CPU_TIMER_HZ/CPU_TICK_HZ )
+/*低功耗空闲时Timer4改为128分频, 8位计数器单次最多覆盖的节拍数*/
+#define __TICK_IDLE_MAX             ( (tick_t)(512/__TICK_RELOAD) )
+/*
+ * 一个节拍的计数值须能写入8位ARR, 否则编译报错, 应降低CPU_TIMER_HZ/CPU_TICK_HZ;
+ * CPU_TIMER_HZ等宏含类型转换, 不能用于#if, 以数组长度检查
+ */
+typedef char __tick_reload_check[((__TICK_RELOAD >= 2) && (__TICK_RELOAD <= 256)) ? 1 : -1];
+#endif
+
 /*******************************************************************************
 
                                     全局变量
 
 *******************************************************************************/
-static ListHead_t cpuTickIRQList;
+static TimeWheel_t cpuTickWheel;
+static ListHead_t cpuTickDeferList;
+static volatile systime_t cpuTickCount = 0;
 static uint32_t fac_ms = 0;
+#ifdef CPU_USE_TICKLESS_IDLE
+/*低功耗空闲预定的节拍数, 为0表示未处于低功耗空闲*/
+static volatile tick_t cpuTickIdle = 0;
+/*进入低功耗空闲时当前节拍已经过去的计数值(64分频)*/
+static uint8_t cpuTickIdleCntr = 0;
+#endif
+
+/*******************************************************************************
+
+                                    私有函数
+
+*******************************************************************************/
+/**
+ * 时间轮定时器到期处理函数, 调用对应的节拍中断服务函数
+ *
+ * @param timer: 到期的时间轮定时器指针
+ */
+static void prvTickIRQDispatch(WheelTimer_t *timer)
+{
+TickIRQ_t *irq = container_of(timer, TickIRQ_t, timer);
+cpu_t cpu_sr;
+
+    if ( !irq->deferred )
+    {
+        (irq->isr)();
+        return;
+    }
+    cpu_sr = CPU_EnterCriticalFromISR();
+    {
+        if ( list_IsEmpty(&irq->deferNode) )
+        {
+            list_AddTail(&cpuTickDeferList, &irq->deferNode);
+        }
+        else
+        {
+            /*上一次到期尚未执行, 合并为一次执行并记为溢出*/
+            irq->overrun++;
+        }
+    }
+    CPU_ExitCriticalFromISR(cpu_sr);
+}
+
+#ifdef CPU_USE_TICKLESS_IDLE
+/**
+ * 退出低功耗空闲, 恢复Timer4的节拍周期
+ *
+ * @param cntr: 当前节拍已经过去的计数值(64分频)
+ */
+static void prvTickIdleRestore(uint8_t cntr)
+{
+    TIM4->CR1 &= ~TIM4_CR1_CEN;
+    TIM4->PSCR = TIM4_PRESCALER_64;
+    TIM4->ARR  = (uint8_t)(__TICK_RELOAD - 1);
+    /*重新装载预分频, URS置位时不产生更新中断*/
+    TIM4->EGR  = TIM4_EGR_UG;
+    TIM4->CNTR = cntr;
+    TIM4->CR1 |= TIM4_CR1_CEN;
+    cpuTickIdle = 0;
+}
+#endif
 
 /*******************************************************************************
 
@@ -27,7 +106,9 @@ void cpu_TickInit(void)
 #ifdef CPU_TICK_PERIOD_IS_1MS
     CPU_Assert(CPU_TICK_HZ == 1000);
 #endif
-    list_Init(&cpuTickIRQList);
+    CPU_Assert(0 == 1000000%CPU_TICK_HZ);
+    wheel_Init(&cpuTickWheel);
+    list_Init(&cpuTickDeferList);
     fac_ms = CPU_TIMER_HZ/1000;
     /*
      * 初始化Timer4
@@ -51,56 +132,338 @@ void cpu_TickInit(void)
  */
 void cpu_TickIRQRegister(TickIRQ_t *irq, tick_t period, TickIRQHandler_t isr)
 {
-cpu_t cpu_sr;
-
     /*参数检验*/
     CPU_Assert(0 != period);
     CPU_Assert(0 != isr);
     /*注册节拍中断*/
-    list_Init(&irq->node);
-    irq->period = period;
-    irq->count  = period-1;
-    irq->isr    = isr;
+    cpu_TickIRQInit(irq, isr);
+    cpu_TickIRQStart(irq, period, period);
+}
+
+/**
+ * 初始化节拍中断请求, 初始化后处于停止状态
+ *
+ * @param irq: 节拍中断请求的结构体指针, 必须未启动
+ *
+ * @param isr: 节拍中断请求的处理函数指针
+ */
+void cpu_TickIRQInit(TickIRQ_t *irq, TickIRQHandler_t isr)
+{
+    CPU_Assert(0 != isr);
+    wheel_TimerInit(&irq->timer, prvTickIRQDispatch);
+    list_Init(&irq->deferNode);
+    irq->isr      = isr;
+    irq->deferred = false;
+    irq->overrun  = 0;
+}
+
+/**
+ * 启动节拍中断请求, 已启动时按新的参数重新启动, O(1)
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @param delay: 首次产生节拍中断前的节拍数, 不能为0
+ *
+ * @param period: 之后产生节拍中断的周期, 为0时为单次节拍中断请求
+ */
+void cpu_TickIRQStart(TickIRQ_t *irq, tick_t delay, tick_t period)
+{
+cpu_t cpu_sr;
+
+    CPU_Assert(0 != delay);
+    cpu_sr = CPU_EnterCritical();
+    {
+        wheel_Del(&irq->timer);
+        wheel_Add(&cpuTickWheel, &irq->timer, delay, period);
+    }
+    CPU_ExitCritical(cpu_sr);
+}
+
+/**
+ * 停止节拍中断请求, O(1), 可在节拍中断服务函数中调用
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @return: 返回布尔值, true表示停止前处于启动状态或有尚未执行的延迟节拍中断,
+ *          false表示已停止或单次节拍中断请求已经执行
+ */
+bool cpu_TickIRQStop(TickIRQ_t *irq)
+{
+bool ret;
+cpu_t cpu_sr;
+
     cpu_sr = CPU_EnterCritical();
     {
-        list_Add(&cpuTickIRQList, &irq->node);
+        ret = wheel_Del(&irq->timer);
+        /*同时取消尚未执行的延迟节拍中断*/
+        if ( !list_IsEmpty(&irq->deferNode) )
+        {
+            list_Del(&irq->deferNode);
+            ret = true;
+        }
     }
     CPU_ExitCritical(cpu_sr);
+    return (ret);
+}
+
+/**
+ * 修改节拍中断请求的周期, 已安排的下一次节拍中断不变, 之后按新的周期产生
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @param period: 新的周期, 为0时下一次节拍中断后停止
+ *
+ * @note: 需要立即以新的周期重新计时时, 使用cpu_TickIRQStart(irq, period, period)
+ */
+void cpu_TickIRQSetPeriod(TickIRQ_t *irq, tick_t period)
+{
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        irq->timer.period = period;
+    }
+    CPU_ExitCritical(cpu_sr);
+}
+
+/**
+ * 判断节拍中断请求是否处于启动状态
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @return: 返回布尔值, true表示处于启动状态
+ */
+bool cpu_TickIRQIsActive(TickIRQ_t *irq)
+{
+    return ( wheel_IsActive(&irq->timer) );
+}
+
+/**
+ * 设置节拍中断请求的执行方式
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @param deferred: true表示到期后由cpu_TickDeferHandler()在主程序循环中执行,
+ *                  节拍中断函数只将其加入延迟执行链表; false表示在节拍中断函数中执行
+ */
+void cpu_TickIRQSetDeferred(TickIRQ_t *irq, bool deferred)
+{
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        irq->deferred = deferred;
+    }
+    CPU_ExitCritical(cpu_sr);
+}
+
+/**
+ * 获取延迟节拍中断请求的溢出次数
+ *
+ * @param irq: 已初始化的节拍中断请求的结构体指针
+ *
+ * @return: 返回到期时上一次到期尚未执行, 被合并执行的次数
+ */
+size_t cpu_TickIRQGetOverrun(TickIRQ_t *irq)
+{
+    return (irq->overrun);
 }
 
 /**
  * (总)节拍中断处理函数
  *
- * @note: 以CPU_TICK_HZ的频率, 在CPU节拍中断函数中调用
+ * @note: 以CPU_TICK_HZ的频率, 在CPU节拍中断函数中调用,
+ *        只处理当前节拍到期的节拍中断请求
  */
 void cpu_TickHandler(void)
 {
-ListNode_t *pos;
+    /*先清除更新标志, 节拍中断服务函数中cpu_GetTimeUs()不会重复计算本节拍*/
+    TIM4->SR1 = (uint8_t)~TIM4_SR1_UIF;
+#ifdef CPU_USE_TICKLESS_IDLE
+    if ( 0 != cpuTickIdle )
+    {
+        /*低功耗空闲到期, 跳过其间的节拍并恢复节拍周期*/
+        wheel_Skip(&cpuTickWheel, cpuTickIdle - 1);
+        cpuTickCount += cpuTickIdle - 1;
+        prvTickIdleRestore(0);
+    }
+#endif
+    cpuTickCount++;
+    wheel_Tick(&cpuTickWheel);
+}
+
+/**
+ * 延迟节拍中断处理函数, 依次执行已到期的延迟节拍中断请求
+ *
+ * @note: STM8S没有可由软件触发的低优先级中断, 在主程序循环中调用,
+ *        使用低功耗空闲时, 每次cpu_TickIdle()返回后调用
+ */
+void cpu_TickDeferHandler(void)
+{
+ListNode_t *pNode;
 TickIRQ_t  *irq;
+cpu_t cpu_sr;
 
-    list_for_each(pos, &cpuTickIRQList)
+    for ( ;; )
     {
-        irq = list_entry(pos, TickIRQ_t, node);
-        if (irq->period > 0)
+        irq = NULL;
+        cpu_sr = CPU_EnterCritical();
         {
-            if (irq->count > 0)
-            {
-                irq->count--;
-            }
-            else
+            if ( !list_IsEmpty(&cpuTickDeferList) )
             {
-                irq->count = irq->period - 1;
-                (irq->isr)();
+                pNode = cpuTickDeferList.next;
+                list_Del(pNode);
+                irq = list_entry(pNode, TickIRQ_t, deferNode);
             }
         }
+        CPU_ExitCritical(cpu_sr);
+        if ( NULL == irq )
+        {
+            break;
+        }
+        (irq->isr)();
     }
 }
 
+#ifdef CPU_USE_TICKLESS_IDLE
+/**
+ * 低功耗空闲, 在主程序空闲循环中调用
+ *
+ * @note: 按下一个需要处理的节拍将Timer4改为128分频并重新设置周期, 在WFI中连续
+ *        睡眠多个节拍; 8位计数器的覆盖范围有限, 单次最多跳过__TICK_IDLE_MAX-1
+ *        个节拍, 不足2个节拍时退化为普通的WFI;
+ *        WFI同时开启中断, Timer4到期时由cpu_TickHandler()修正节拍,
+ *        被其他中断提前唤醒时由本函数按已经过去的计数修正节拍
+ *
+ * @return: 返回跳过的节拍数, 这些节拍不会产生节拍中断,
+ *          节拍中断函数中的其他节拍使用者(如调度器)需要据此补偿
+ */
+tick_t cpu_TickIdle(void)
+{
+uint16_t count;
+tick_t idle, skip;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    /*有尚未执行的延迟节拍中断时不进入低功耗空闲*/
+    if ( !list_IsEmpty(&cpuTickDeferList) )
+    {
+        CPU_ExitCritical(cpu_sr);
+        return (0);
+    }
+    idle = wheel_NextExpiry(&cpuTickWheel);
+    if ( idle > __TICK_IDLE_MAX )
+    {
+        idle = __TICK_IDLE_MAX;
+    }
+    if ( idle < 2 )
+    {
+        CPU_WFI();
+        CPU_ExitCritical(cpu_sr);
+        return (0);
+    }
+    /*停止Timer4, 节拍中断已挂起时放弃本次低功耗空闲*/
+    TIM4->CR1 &= ~TIM4_CR1_CEN;
+    if ( 0 != (TIM4->SR1 & TIM4_SR1_UIF) )
+    {
+        TIM4->CR1 |= TIM4_CR1_CEN;
+        CPU_ExitCritical(cpu_sr);
+        return (0);
+    }
+    /*当前节拍的剩余计数加上idle-1个完整节拍, 换算为128分频*/
+    cpuTickIdleCntr = TIM4->CNTR;
+    count = (uint16_t)(__TICK_RELOAD*idle - cpuTickIdleCntr);
+    TIM4->PSCR = TIM4_PRESCALER_128;
+    TIM4->ARR  = (uint8_t)(count/2 - 1);
+    TIM4->CR1 |= TIM4_CR1_URS;
+    TIM4->EGR  = TIM4_EGR_UG;
+    cpuTickIdle = idle;
+    TIM4->CR1 |= TIM4_CR1_CEN;
+    CPU_WFI();
+    CPU_DisableInterrupts();
+    skip = idle - 1;
+    if ( (0 != cpuTickIdle) && (0 == (TIM4->SR1 & TIM4_SR1_UIF)) )
+    {
+        /*被其他中断提前唤醒, 按已经过去的计数修正节拍*/
+        TIM4->CR1 &= ~TIM4_CR1_CEN;
+        count = (uint16_t)cpuTickIdleCntr + 2*(uint16_t)TIM4->CNTR;
+        skip  = (tick_t)(count/__TICK_RELOAD);
+        wheel_Skip(&cpuTickWheel, skip);
+        cpuTickCount += skip;
+        prvTickIdleRestore((uint8_t)(count%__TICK_RELOAD));
+    }
+    CPU_ExitCritical(cpu_sr);
+    return (skip);
+}
+#endif  /* CPU_USE_TICKLESS_IDLE */
+
 /*******************************************************************************
 
                                     时间管理
 
 *******************************************************************************/
+/**
+ * 获取CPU节拍计数
+ *
+ * @return: 返回cpu_TickInit()之后经过的节拍数, 单调递增(按systime_t回绕)
+ */
+systime_t cpu_GetTicks(void)
+{
+systime_t ticks;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        ticks = cpuTickCount;
+    }
+    CPU_ExitCritical(cpu_sr);
+    return (ticks);
+}
+
+/**
+ * 获取微秒级单调时间, 由节拍计数与Timer4当前计数合成
+ *
+ * @return: 返回cpu_TickInit()之后经过的时间(us), 单调递增(按systime_t回绕)
+ */
+systime_t cpu_GetTimeUs(void)
+{
+systime_t ticks;
+uint16_t cntr;
+cpu_t cpu_sr;
+
+    cpu_sr = CPU_EnterCritical();
+    {
+        ticks = cpuTickCount;
+        cntr  = TIM4->CNTR;
+#ifdef CPU_USE_TICKLESS_IDLE
+        if ( 0 != cpuTickIdle )
+        {
+            /*低功耗空闲期间Timer4为128分频, 从进入空闲前的节拍边界开始计算*/
+            if ( 0 != (TIM4->SR1 & TIM4_SR1_UIF) )
+            {
+                ticks += cpuTickIdle;
+                cntr   = 2*(uint16_t)TIM4->CNTR;
+            }
+            else
+            {
+                cntr   = (uint16_t)cpuTickIdleCntr + 2*cntr;
+                ticks += cntr/__TICK_RELOAD;
+                cntr   = cntr%__TICK_RELOAD;
+            }
+        }
+        else
+#endif
+        /*Timer4已回绕但节拍中断尚未处理, 补上该节拍并重新读取计数值*/
+        if ( 0 != (TIM4->SR1 & TIM4_SR1_UIF) )
+        {
+            ticks++;
+            cntr = TIM4->CNTR;
+        }
+    }
+    CPU_ExitCritical(cpu_sr);
+    return ( ticks*(1000000/CPU_TICK_HZ) + (systime_t)cntr*1000/fac_ms );
+}
+
 /**
  * 定时器节拍延时函数
  *
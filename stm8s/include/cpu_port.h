@@ -91,8 +91,18 @@ typedef __istate_t      cpu_t;
 
 /* 底层操作宏 ----------------------------------------------------------------*/
 #define CPU_NOP()               __no_operation()
+/*数据内存屏障, STM8S为单核顺序执行, 仅需阻止编译器跨越屏障重排内存访问*/
+#define CPU_DMB()               asm("")
+/*进入等待模式, 直到下一个中断到来*/
+#define CPU_WFI()               __wait_for_interrupt()
 
 /* CPU中断管理 ---------------------------------------------------------------*/
+/*
+ * 判断CPU是否处于处理模式, CC寄存器I1:I0为10时为主程序且中断使能;
+ * 中断优先级3与主程序中关闭中断无法区分, 后者同样返回真
+ */
+#define cpu_InHandlerMode()     ( 0x20 != (__get_interrupt_state() & 0x28) )
+
 #define cpu_irq_enable()        __enable_interrupt()
 #define cpu_irq_disable()       __disable_interrupt()
 
@@ -109,4 +119,27 @@ STATIC_INLINE void cpu_irq_restore(cpu_t cpu_sr)
     __set_interrupt_state(cpu_sr);
 }
 
+/* CPU原子操作 ---------------------------------------------------------------*/
+/*
+ * 原子比较交换, STM8S无独占访问指令, 短暂关闭中断实现
+ * ptr:      目标地址
+ * expected: 期望值
+ * desired:  新值
+ * return:   若*ptr等于expected, 写入desired并返回true, 否则返回false
+ */
+STATIC_INLINE bool cpu_AtomicCAS(volatile size_t *ptr, size_t expected, size_t desired)
+{
+bool ret = false;
+cpu_t cpu_sr;
+
+    cpu_sr = cpu_irq_save();
+    if ( *ptr == expected )
+    {
+        *ptr = desired;
+        ret  = true;
+    }
+    cpu_irq_restore(cpu_sr);
+    return (ret);
+}
+
 #endif  /* __CPU_PORT_H */
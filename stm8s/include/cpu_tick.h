@@ -12,19 +12,26 @@
 
 /* 头文件 --------------------------------------------------------------------*/
 #include "cpu_port.h"
-#include "cpulib_list.h"
+#include "cpulib_wheel.h"
 
 /* 数据结构 ------------------------------------------------------------------*/
 /*节拍处理函数类型*/
 typedef void (*TickIRQHandler_t) (void);
+/*
+ * 单调时间类型, 节拍数或微秒数;
+ * IAR STM8编译器不支持64位整数, 单调时间为32位, 以无符号差值计算时间间隔时
+ * 可正确处理回绕(微秒约71分钟回绕一次)
+ */
+typedef uint32_t            systime_t;
 /*节拍中断请求结构体类型*/
 typedef struct tick_irq TickIRQ_t;
 struct tick_irq
 {
-    tick_t              period; /*产生节拍的周期  */
-    tick_t volatile     count;  /*内部计数器      */
-    TickIRQHandler_t    isr;    /*节拍中断服务函数*/
-    ListNode_t          node;   /*节拍链表结点    */
+    WheelTimer_t        timer;      /*时间轮定时器        */
+    TickIRQHandler_t    isr;        /*节拍中断服务函数    */
+    bool                deferred;   /*延迟到中断外执行    */
+    volatile size_t     overrun;    /*延迟执行被合并的次数*/
+    ListNode_t          deferNode;  /*延迟执行链表结点    */
 };
 
 /* 节拍转换宏 ----------------------------------------------------------------*/
@@ -39,7 +46,20 @@ struct tick_irq
 /* 接口函数 ------------------------------------------------------------------*/
 void cpu_TickInit(void);
 void cpu_TickIRQRegister(TickIRQ_t *irq, tick_t period, TickIRQHandler_t isr);
+void cpu_TickIRQInit(TickIRQ_t *irq, TickIRQHandler_t isr);
+void cpu_TickIRQStart(TickIRQ_t *irq, tick_t delay, tick_t period);
+bool cpu_TickIRQStop(TickIRQ_t *irq);
+void cpu_TickIRQSetPeriod(TickIRQ_t *irq, tick_t period);
+bool cpu_TickIRQIsActive(TickIRQ_t *irq);
+void cpu_TickIRQSetDeferred(TickIRQ_t *irq, bool deferred);
+size_t cpu_TickIRQGetOverrun(TickIRQ_t *irq);
 void cpu_TickHandler(void);
+void cpu_TickDeferHandler(void);
+#ifdef CPU_USE_TICKLESS_IDLE
+tick_t cpu_TickIdle(void);
+#endif
+systime_t cpu_GetTicks(void);
+systime_t cpu_GetTimeUs(void);
 void cpu_Delay(uint32_t n);
 void cpu_DelayMs(uint16_t nms);
 